@@ -0,0 +1,43 @@
+#ifndef XEMU_PERF_TESTS_JSON_PARSER_H
+#define XEMU_PERF_TESTS_JSON_PARSER_H
+
+#include <list>
+#include <string>
+
+#include "tiny-json.h"
+
+//! C++ wrapper around Tiny-JSON jsonPool_t
+class JSONParser : jsonPool_t {
+ public:
+  JSONParser() : jsonPool_t{&Alloc, &Alloc} {}
+  explicit JSONParser(const char* str) : jsonPool_t{&Alloc, &Alloc}, json_string_{str} {
+    root_node_ = json_createWithPool(json_string_.data(), this);
+  }
+
+  JSONParser(const JSONParser&) = delete;
+  JSONParser(JSONParser&&) = delete;
+  JSONParser& operator=(const JSONParser&) = delete;
+  JSONParser& operator=(JSONParser&&) = delete;
+
+  //! Parses the given string, replacing any previously parsed content.
+  void Parse(const char* str) {
+    object_list_.clear();
+    json_string_ = str;
+    root_node_ = json_createWithPool(json_string_.data(), this);
+  }
+
+  [[nodiscard]] json_t const* root() const { return root_node_; }
+
+ private:
+  static json_t* Alloc(jsonPool_t* pool) {
+    const auto list_pool = static_cast<JSONParser*>(pool);
+    list_pool->object_list_.emplace_back();
+    return &list_pool->object_list_.back();
+  }
+
+  std::list<json_t> object_list_{};
+  std::string json_string_{};
+  json_t const* root_node_{};
+};
+
+#endif  // XEMU_PERF_TESTS_JSON_PARSER_H
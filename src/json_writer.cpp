@@ -0,0 +1,140 @@
+#include "json_writer.h"
+
+#include <cmath>
+#include <iomanip>
+
+#include "debug_output.h"
+
+// Enough significant digits to represent nanosecond timings of long runs without resorting to exponents.
+static constexpr int kDoublePrecision = 15;
+
+JsonWriter::JsonWriter() { out_ << std::setprecision(kDoublePrecision); }
+
+void JsonWriter::BeginValue(const char *key) {
+  if (!container_has_values_.empty()) {
+    if (container_has_values_.back()) {
+      out_ << ",";
+    }
+    container_has_values_.back() = true;
+  }
+
+  if (key) {
+    out_ << Escape(key) << ":";
+  }
+}
+
+JsonWriter &JsonWriter::BeginObject(const char *key) {
+  BeginValue(key);
+  out_ << "{";
+  container_has_values_.push_back(false);
+  return *this;
+}
+
+JsonWriter &JsonWriter::EndObject() {
+  ASSERT(!container_has_values_.empty() && "EndObject called without a matching BeginObject");
+  container_has_values_.pop_back();
+  out_ << "}";
+  return *this;
+}
+
+JsonWriter &JsonWriter::BeginArray(const char *key) {
+  BeginValue(key);
+  out_ << "[";
+  container_has_values_.push_back(false);
+  return *this;
+}
+
+JsonWriter &JsonWriter::EndArray() {
+  ASSERT(!container_has_values_.empty() && "EndArray called without a matching BeginArray");
+  container_has_values_.pop_back();
+  out_ << "]";
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, const std::string &value) {
+  BeginValue(key);
+  out_ << Escape(value);
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, const char *value) {
+  if (!value) {
+    return AddNull(key);
+  }
+  BeginValue(key);
+  out_ << Escape(value);
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, bool value) {
+  BeginValue(key);
+  out_ << (value ? "true" : "false");
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, int32_t value) {
+  BeginValue(key);
+  out_ << value;
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, uint32_t value) {
+  BeginValue(key);
+  out_ << value;
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, uint64_t value) {
+  BeginValue(key);
+  out_ << value;
+  return *this;
+}
+
+JsonWriter &JsonWriter::Add(const char *key, double value) {
+  if (!std::isfinite(value)) {
+    return AddNull(key);
+  }
+  BeginValue(key);
+  out_ << value;
+  return *this;
+}
+
+JsonWriter &JsonWriter::AddNull(const char *key) {
+  BeginValue(key);
+  out_ << "null";
+  return *this;
+}
+
+std::string JsonWriter::Escape(const std::string &value) {
+  std::string ret = "\"";
+  for (auto c : value) {
+    switch (c) {
+      case '"':
+        ret += "\\\"";
+        break;
+      case '\\':
+        ret += "\\\\";
+        break;
+      case '\n':
+        ret += "\\n";
+        break;
+      case '\r':
+        ret += "\\r";
+        break;
+      case '\t':
+        ret += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          ret += buffer;
+        } else {
+          ret += c;
+        }
+        break;
+    }
+  }
+  ret += "\"";
+  return ret;
+}
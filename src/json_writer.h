@@ -0,0 +1,59 @@
+#ifndef XEMU_PERF_TESTS_JSON_WRITER_H
+#define XEMU_PERF_TESTS_JSON_WRITER_H
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Builds a compact, single line JSON document.
+ *
+ * Containers are opened and closed explicitly. Keys must be provided for values within objects and omitted (nullptr)
+ * for values within arrays.
+ */
+class JsonWriter {
+ public:
+  JsonWriter();
+
+  JsonWriter &BeginObject(const char *key = nullptr);
+  JsonWriter &EndObject();
+  JsonWriter &BeginArray(const char *key = nullptr);
+  JsonWriter &EndArray();
+
+  JsonWriter &Add(const char *key, const std::string &value);
+  JsonWriter &Add(const char *key, const char *value);
+  JsonWriter &Add(const char *key, bool value);
+  JsonWriter &Add(const char *key, int32_t value);
+  JsonWriter &Add(const char *key, uint32_t value);
+  JsonWriter &Add(const char *key, uint64_t value);
+  //! Non-finite values are written as null.
+  JsonWriter &Add(const char *key, double value);
+  JsonWriter &AddNull(const char *key);
+
+  template <typename T>
+  JsonWriter &AddArray(const char *key, const std::vector<T> &values) {
+    BeginArray(key);
+    for (const auto &value : values) {
+      Add(nullptr, value);
+    }
+    return EndArray();
+  }
+
+  //! Returns the document built so far.
+  [[nodiscard]] std::string str() const { return out_.str(); }
+
+  //! Returns the given string as a quoted JSON string literal.
+  static std::string Escape(const std::string &value);
+
+ private:
+  //! Writes the separator and key (if any) that precede a value.
+  void BeginValue(const char *key);
+
+ private:
+  std::ostringstream out_;
+  //! For each open container, whether it already contains a value.
+  std::vector<bool> container_has_values_;
+};
+
+#endif  // XEMU_PERF_TESTS_JSON_WRITER_H
@@ -4,25 +4,117 @@
 
 Logger* Logger::singleton_ = nullptr;
 
-Logger::Logger(const std::string& log_path, bool truncate_log) : log_path_(log_path) {
+Logger::Logger(const std::string& log_path, bool truncate_log, bool in_memory, const std::string& raw_samples_path)
+    : log_path_(log_path), in_memory_(in_memory), has_raw_samples_(!raw_samples_path.empty()) {
   const char* p = log_path.c_str();
   PrintMsg("Opening log file at %s\n", p);
 
-  if (truncate_log) {
-    auto log_file = std::ofstream(log_path, std::ios_base::trunc);
-    ASSERT(log_file && "Failed to open log file for output");
+  log_file_.open(log_path, truncate_log ? std::ios_base::trunc : std::ios_base::app);
+  ASSERT(log_file_ && "Failed to open log file for output");
+
+  if (has_raw_samples_) {
+    PrintMsg("Opening raw samples file at %s\n", raw_samples_path.c_str());
+    raw_samples_file_.open(raw_samples_path, std::ios_base::binary | std::ios_base::trunc);
+    ASSERT(raw_samples_file_ && "Failed to open raw samples file for output");
   }
 }
 
-void Logger::Initialize(const std::string& log_path, bool truncate_log) {
+void Logger::Initialize(const std::string& log_path, bool truncate_log, bool in_memory,
+                        const std::string& raw_samples_path) {
   ASSERT(!singleton_ && "Invalid attempt to initialize logger twice.");
 
-  singleton_ = new Logger(log_path, truncate_log);
+  singleton_ = new Logger(log_path, truncate_log, in_memory, raw_samples_path);
+}
+
+std::ostream& Logger::Log() {
+  ASSERT(singleton_ && "Attempt to use Logger before Initialize");
+  return singleton_->buffer_;
+}
+
+bool Logger::HasRawSamples() { return singleton_ && singleton_->has_raw_samples_; }
+
+std::ostream& Logger::RawSamples() {
+  ASSERT(HasRawSamples() && "Attempt to write raw samples without a sidecar file");
+  return singleton_->raw_samples_buffer_;
 }
 
-std::ofstream Logger::Log() {
+void Logger::EnableStreaming(ResultStream::Transport transport) {
   ASSERT(singleton_ && "Attempt to use Logger before Initialize");
-  auto log_file = std::ofstream(singleton_->log_path_, std::ios_base::app);
-  ASSERT(log_file && "Failed to open log file for output");
-  return log_file;
+  if (transport == ResultStream::Transport::NONE) {
+    singleton_->stream_.reset();
+    return;
+  }
+
+  PrintMsg("Streaming results via %s\n", ResultStream::TransportName(transport));
+  singleton_->stream_ = std::make_unique<ResultStream>(transport);
+}
+
+void Logger::Flush() {
+  if (!singleton_) {
+    return;
+  }
+
+  singleton_->StreamBuffer();
+  if (!singleton_->in_memory_) {
+    singleton_->WriteBuffer();
+  }
+}
+
+void Logger::Close() {
+  if (!singleton_) {
+    return;
+  }
+
+  singleton_->StreamBuffer();
+  singleton_->WriteBuffer();
+  singleton_->log_file_.close();
+  if (singleton_->has_raw_samples_) {
+    singleton_->raw_samples_file_.close();
+  }
+  delete singleton_;
+  singleton_ = nullptr;
+}
+
+void Logger::WriteBuffer() {
+  // Avoid touching the disk when nothing has been logged, as Flush is called after every frame in continuous mode.
+  if (buffer_.tellp() > 0) {
+    log_file_ << buffer_.str();
+    log_file_.flush();
+    ASSERT(log_file_ && "Failed to write log file");
+
+    buffer_.str("");
+    buffer_.clear();
+    streamed_length_ = 0;
+  }
+
+  if (has_raw_samples_ && raw_samples_buffer_.tellp() > 0) {
+    raw_samples_file_ << raw_samples_buffer_.str();
+    raw_samples_file_.flush();
+    ASSERT(raw_samples_file_ && "Failed to write raw samples file");
+
+    raw_samples_buffer_.str("");
+    raw_samples_buffer_.clear();
+  }
+}
+
+void Logger::StreamBuffer() {
+  const auto buffered_length = static_cast<std::streamoff>(buffer_.tellp());
+  if (!stream_ || buffered_length <= static_cast<std::streamoff>(streamed_length_)) {
+    return;
+  }
+
+  // Only copy the output logged since the previous call, rather than the entire buffer, which may hold the results of
+  // the whole run in in-memory mode. An incomplete trailing line is read again by the next call.
+  std::string content(static_cast<std::string::size_type>(buffered_length) - streamed_length_, '\0');
+  buffer_.seekg(static_cast<std::streamoff>(streamed_length_));
+  buffer_.read(&content[0], static_cast<std::streamsize>(content.size()));
+  ASSERT(buffer_ && "Failed to read back log buffer");
+
+  std::string::size_type line_start = 0;
+  for (auto line_end = content.find('\n', line_start); line_end != std::string::npos;
+       line_end = content.find('\n', line_start)) {
+    stream_->Send(content.substr(line_start, line_end - line_start));
+    line_start = line_end + 1;
+  }
+  streamed_length_ += line_start;
 }
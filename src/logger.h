@@ -2,18 +2,69 @@
 #define XEMU_PERF_TESTS_LOGGER_H
 
 #include <fstream>
+#include <memory>
+#include <sstream>
 #include <string>
 
+#include "result_stream.h"
+
+/**
+ * Writes results to a single, persistently open log file.
+ *
+ * Output is accumulated in memory and only written to disk when Flush or Close is called, so that file I/O can be
+ * confined to points where it will not perturb measurements.
+ */
 class Logger {
  public:
-  static void Initialize(const std::string &log_path, bool truncate_log);
+  /**
+   * Opens the log file at the given path.
+   * @param log_path - The path to the log file.
+   * @param truncate_log - Whether any existing content in the log file should be discarded.
+   * @param in_memory - If true, Flush is ignored and all output is held in memory until Close.
+   * @param raw_samples_path - If not empty, the path to a binary sidecar file to which raw samples should be written
+   *                           (see raw_sample_encoding.h). The sidecar is always truncated.
+   */
+  static void Initialize(const std::string &log_path, bool truncate_log, bool in_memory = false,
+                         const std::string &raw_samples_path = "");
+
+  //! Returns the stream to which log output should be written.
+  static std::ostream &Log();
+
+  //! Returns true if a raw samples sidecar was requested in Initialize.
+  static bool HasRawSamples();
+  //! Returns the binary stream to which raw samples should be written.
+  static std::ostream &RawSamples();
+
+  //! Additionally sends every complete line of output through the given transport as it is flushed. Lines are
+  //! streamed even in in-memory mode. Raw samples written to the sidecar are not streamed.
+  static void EnableStreaming(ResultStream::Transport transport);
 
-  static std::ofstream Log();
+  //! Writes any buffered output to disk. Does nothing in in-memory mode.
+  static void Flush();
+
+  //! Writes any buffered output to disk and closes the log file.
+  static void Close();
 
  private:
-  explicit Logger(const std::string &path, bool truncate_log = false);
+  Logger(const std::string &path, bool truncate_log, bool in_memory, const std::string &raw_samples_path);
+
+  void WriteBuffer();
+  //! Streams any complete lines that have been logged since the last call.
+  void StreamBuffer();
 
   std::string log_path_;
+  bool in_memory_;
+  std::ofstream log_file_;
+  //! Readable so that StreamBuffer can extract only the output logged since the previous call.
+  std::stringstream buffer_;
+
+  bool has_raw_samples_;
+  std::ofstream raw_samples_file_;
+  std::ostringstream raw_samples_buffer_;
+
+  std::unique_ptr<ResultStream> stream_;
+  //! Number of characters at the start of buffer_ that have already been streamed.
+  std::string::size_type streamed_length_{0};
 
   static Logger *singleton_;
 };
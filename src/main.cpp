@@ -17,8 +17,11 @@
 #include <windows.h>
 #pragma clang diagnostic pop
 
+#include "configure.h"
 #include "debug_output.h"
+#include "json_writer.h"
 #include "logger.h"
+#include "raw_sample_encoding.h"
 #include "runtime_config.h"
 #include "test_driver.h"
 #include "test_host.h"
@@ -30,8 +33,15 @@
 #include "tests/tiny_draw_tests.h"
 #include "tests/uniform_thrash_tests.h"
 #include "tests/vertex_buffer_allocation_tests.h"
+#include "trace_recorder.h"
 
-static constexpr const char* kLogFileName = "results.txt";
+static constexpr const char* kLogFileName = "results.ndjson";
+static constexpr const char* kRawSamplesFileName = "results.samples";
+static constexpr const char* kTraceFileName = "trace.json";
+static constexpr const char* kTestPlanFileName = "test_plan.txt";
+//! Version of the record layout written to kLogFileName. Incremented whenever existing fields change meaning or are
+//! removed; consumers should tolerate unknown fields.
+static constexpr uint32_t kResultsSchemaVersion = 2;
 
 static const int kFramebufferWidth = 640;
 static const int kFramebufferHeight = 480;
@@ -46,6 +56,8 @@ const UCHAR kSMCPowerShutdown = 0x80;
 static bool EnsureDriveMounted(char drive_letter);
 static bool LoadConfig(RuntimeConfig& config, std::vector<std::string>& errors);
 static void RunTests(RuntimeConfig& config, TestHost& host, std::vector<std::shared_ptr<TestSuite>>& test_suites);
+static void WriteTestPlan(RuntimeConfig& config, TestHost& host, std::vector<std::shared_ptr<TestSuite>>& test_suites);
+static void LogRunHeader(const RuntimeConfig& config, const TestHost& host);
 static void RegisterSuites(TestHost& host, RuntimeConfig& config, std::vector<std::shared_ptr<TestSuite>>& test_suites,
                            const std::string& output_directory);
 static void Shutdown();
@@ -95,6 +107,13 @@ int main() {
       for (auto& err : errors) {
         debugPrint("%s\n", err.c_str());
       }
+      errors.clear();
+      if (!config.LoadDefaultConfig(errors)) {
+        debugPrint("Failed to apply profile '%s'.\n", config.profile().c_str());
+        for (auto& err : errors) {
+          debugPrint("%s\n", err.c_str());
+        }
+      }
       pb_show_debug_screen();
     }
   }
@@ -112,6 +131,11 @@ int main() {
 
   std::vector<std::shared_ptr<TestSuite>> test_suites;
   TestHost host(kFramebufferWidth, kFramebufferHeight);
+  host.SetTimingMode(config.timing_mode());
+  host.SetTimerSource(config.timer_source());
+  host.SetCaptureFramebuffers(config.capture_framebuffers());
+  // Resuming a run implies checkpointing it, so that a run that is resumed and crashes again can be resumed again.
+  host.SetWriteCheckpoints(config.write_checkpoints() || config.resume_from_checkpoints());
   RegisterSuites(host, config, test_suites, config.output_directory_path());
 
   {
@@ -128,6 +152,12 @@ int main() {
     }
   }
 
+  if (config.dry_run()) {
+    WriteTestPlan(config, host, test_suites);
+    pb_kill();
+    return 0;
+  }
+
   pb_show_front_screen();
   debugClearScreen();
   RunTests(config, host, test_suites);
@@ -187,16 +217,41 @@ static void Shutdown() {
 static void RunTests(RuntimeConfig& config, TestHost& host, std::vector<std::shared_ptr<TestSuite>>& test_suites) {
   std::string log_file = config.output_directory_path() + "\\" + kLogFileName;
   DeleteFile(log_file.c_str());
-  Logger::Initialize(log_file, true);
+  std::string raw_samples_file;
+  if (config.binary_raw_samples()) {
+    raw_samples_file = config.output_directory_path() + "\\" + kRawSamplesFileName;
+  }
+  Logger::Initialize(log_file, true, config.buffer_results_in_memory(), raw_samples_file);
+  Logger::EnableStreaming(config.stream_results());
+  if (config.trace_events()) {
+    TraceRecorder::Initialize(config.output_directory_path() + "\\" + kTraceFileName, host,
+                              config.buffer_results_in_memory());
+  }
 
   TestDriver driver(host, test_suites, kFramebufferWidth, kFramebufferHeight, false, config.disable_autorun(),
                     config.enable_autorun_immediately());
+  driver.SetRunPlan(config.repeat_passes(), config.test_order(), config.random_seed());
+  driver.SetResumeFromCheckpoints(config.resume_from_checkpoints());
+
+  LogRunHeader(config, host);
+  Logger::Flush();
 
-  Logger::Log() << "[" << std::endl;
+  auto run_start = host.ReadTimer();
   driver.Run();
-  Logger::Log() << "]" << std::endl;
+  auto run_duration = host.GetTicksSince(run_start);
+
+  // The footer is only written if the test loop completes, so its absence identifies a truncated run.
+  JsonWriter footer;
+  footer.BeginObject();
+  footer.Add("type", "run_footer");
+  footer.Add("completed", true);
+  footer.Add("run_duration_ns", host.TicksToNanoseconds(run_duration));
+  footer.EndObject();
+  Logger::Log() << footer.str() << std::endl;
+
   PrintMsg("Test loop completed normally\n");
-  Logger::Log().close();
+  Logger::Close();
+  TraceRecorder::Close();
 
   if (config.enable_shutdown_on_completion()) {
     debugPrint("Results written to %s\n\nShutting down in %d seconds...\n", config.output_directory_path().c_str(),
@@ -213,9 +268,67 @@ static void RunTests(RuntimeConfig& config, TestHost& host, std::vector<std::sha
   }
 }
 
+static void WriteTestPlan(RuntimeConfig& config, TestHost& host, std::vector<std::shared_ptr<TestSuite>>& test_suites) {
+  TestDriver driver(host, test_suites, kFramebufferWidth, kFramebufferHeight, false, config.disable_autorun(),
+                    config.enable_autorun_immediately());
+  driver.SetRunPlan(config.repeat_passes(), config.test_order(), config.random_seed());
+
+  auto plan_file = config.output_directory_path() + "\\" + kTestPlanFileName;
+  auto num_tests = driver.WriteRunPlan(plan_file);
+
+  debugClearScreen();
+  debugPrint("Dry run: %u tests planned, no tests were executed.\nTest plan written to %s\n\n", num_tests,
+             plan_file.c_str());
+  debugPrint("%s in %d seconds...\n", config.enable_shutdown_on_completion() ? "Shutting down" : "Rebooting",
+             config.reboot_or_shutdown_delay_ms() / 1000);
+  pb_show_debug_screen();
+  Sleep(config.reboot_or_shutdown_delay_ms());
+
+  if (config.enable_shutdown_on_completion()) {
+    Shutdown();
+  }
+}
+
+static void LogRunHeader(const RuntimeConfig& config, const TestHost& host) {
+  // The performance counter starts at zero when the console boots, so its current value is the time spent booting
+  // and loading the XBE (plus any time spent waiting in the menu before an interactive run).
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  auto boot_to_run_nanoseconds =
+      static_cast<uint64_t>(static_cast<double>(now.QuadPart) * 1000000000.0 / host.GetPerformanceCounterFrequency());
+
+  JsonWriter header;
+  header.BeginObject();
+  header.Add("type", "run_header");
+  header.Add("schema_version", kResultsSchemaVersion);
+  header.Add("git_revision", GIT_REVISION);
+  header.Add("profile", config.profile());
+  header.BeginObject("framebuffer");
+  header.Add("width", static_cast<uint32_t>(kFramebufferWidth));
+  header.Add("height", static_cast<uint32_t>(kFramebufferHeight));
+  header.Add("bits_per_pixel", static_cast<uint32_t>(kBitsPerPixel));
+  header.EndObject();
+  header.Add("timer_source", TestHost::TimerSourceName(host.GetTimerSource()));
+  header.Add("timer_frequency", host.GetTimerFrequency());
+  header.Add("boot_to_run_ns", boot_to_run_nanoseconds);
+  if (Logger::HasRawSamples()) {
+    header.Add("raw_samples_file", kRawSamplesFileName);
+    WriteRawSampleHeader(Logger::RawSamples(), host.GetTimerFrequency());
+  }
+  if (TraceRecorder::IsEnabled()) {
+    header.Add("trace_file", kTraceFileName);
+  }
+  header.BeginObject("config");
+  config.WriteSettings(header);
+  header.EndObject();
+  header.EndObject();
+
+  Logger::Log() << header.str() << std::endl;
+}
+
 static void RegisterSuites(TestHost& host, RuntimeConfig& runtime_config,
                            std::vector<std::shared_ptr<TestSuite>>& test_suites, const std::string& output_directory) {
-  auto config = TestSuite::Config{};
+  const auto& config = runtime_config.suite_config();
 
 #define REG_TEST(CLASS_NAME)                                                   \
   {                                                                            \
@@ -0,0 +1,51 @@
+#include "raw_sample_encoding.h"
+
+static constexpr char kRawSampleMagic[4] = {'X', 'P', 'R', 'S'};
+static constexpr uint8_t kFlagHasSubmitSamples = 0x01;
+
+static void WriteFixed(std::ostream &out, uint64_t value, uint32_t num_bytes) {
+  for (uint32_t i = 0; i < num_bytes; ++i) {
+    out.put(static_cast<char>(value & 0xFF));
+    value >>= 8;
+  }
+}
+
+static void WriteVarint(std::ostream &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.put(static_cast<char>(value));
+}
+
+static void WriteSamples(std::ostream &out, const std::vector<uint64_t> &samples) {
+  WriteVarint(out, samples.size());
+
+  // Consecutive samples are usually within a few ticks of each other, so zigzag encoded deltas typically fit in one or
+  // two bytes.
+  uint64_t previous = 0;
+  for (auto sample : samples) {
+    auto delta = static_cast<int64_t>(sample - previous);
+    auto zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+    WriteVarint(out, zigzag);
+    previous = sample;
+  }
+}
+
+void WriteRawSampleHeader(std::ostream &out, uint64_t timer_frequency) {
+  out.write(kRawSampleMagic, sizeof(kRawSampleMagic));
+  WriteFixed(out, kRawSampleFormatVersion, 4);
+  WriteFixed(out, timer_frequency, 8);
+}
+
+void WriteRawSampleRecord(std::ostream &out, const std::string &name, const std::vector<uint64_t> &raw_ticks,
+                          const std::vector<uint64_t> *raw_submit_ticks) {
+  WriteVarint(out, name.size());
+  out.write(name.data(), static_cast<std::streamsize>(name.size()));
+  out.put(static_cast<char>(raw_submit_ticks ? kFlagHasSubmitSamples : 0));
+
+  WriteSamples(out, raw_ticks);
+  if (raw_submit_ticks) {
+    WriteSamples(out, *raw_submit_ticks);
+  }
+}
@@ -0,0 +1,36 @@
+#ifndef XEMU_PERF_TESTS_RAW_SAMPLE_ENCODING_H
+#define XEMU_PERF_TESTS_RAW_SAMPLE_ENCODING_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Compact binary encoding of per-iteration timer ticks, written as a sidecar to the results file.
+ *
+ * All multi-byte fixed width values are little endian. The file begins with a header:
+ *   char[4]  magic ("XPRS")
+ *   uint32   version (kRawSampleFormatVersion)
+ *   uint64   timer frequency in ticks per second
+ *
+ * followed by one record per test_result, in the same order as the results file:
+ *   varint   name length, followed by the name bytes
+ *   uint8    flags (bit 0: submit samples are present)
+ *   varint   sample count, followed by that many zigzag varint deltas of raw_ticks
+ *   [varint  sample count, followed by that many zigzag varint deltas of raw_submit_ticks]
+ *
+ * Each delta is relative to the previous sample in the same array, the first to 0. Varints are unsigned LEB128.
+ *
+ * See utils/decode_raw_samples.py for the host side decoder.
+ */
+
+static constexpr uint32_t kRawSampleFormatVersion = 1;
+
+void WriteRawSampleHeader(std::ostream &out, uint64_t timer_frequency);
+
+//! Appends a record for the given test. `raw_submit_ticks` may be null if submit times were not captured.
+void WriteRawSampleRecord(std::ostream &out, const std::string &name, const std::vector<uint64_t> &raw_ticks,
+                          const std::vector<uint64_t> *raw_submit_ticks);
+
+#endif  // XEMU_PERF_TESTS_RAW_SAMPLE_ENCODING_H
@@ -0,0 +1,111 @@
+#include "result_stream.h"
+
+#include <algorithm>
+
+#include "debug_output.h"
+
+static constexpr char kFrameMagic[] = "@XPT1";
+// Kernel debug output truncates long messages, so frames are kept comfortably short.
+static constexpr uint32_t kMaxChunkSize = 200;
+
+static constexpr uint16_t kCOM1Base = 0x3F8;
+static constexpr uint16_t kUARTData = kCOM1Base + 0;
+static constexpr uint16_t kUARTInterruptEnable = kCOM1Base + 1;
+static constexpr uint16_t kUARTFIFOControl = kCOM1Base + 2;
+static constexpr uint16_t kUARTLineControl = kCOM1Base + 3;
+static constexpr uint16_t kUARTModemControl = kCOM1Base + 4;
+static constexpr uint16_t kUARTLineStatus = kCOM1Base + 5;
+static constexpr uint8_t kLineStatusTransmitterEmpty = 0x20;
+// 115200 baud.
+static constexpr uint16_t kUARTDivisor = 1;
+// Upper bound on polls of the line status register per byte, so that a missing UART cannot hang the run.
+static constexpr uint32_t kMaxTransmitPolls = 100000;
+
+static inline void WritePort(uint16_t port, uint8_t value) {
+  __asm__ __volatile__("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t ReadPort(uint16_t port) {
+  uint8_t ret;
+  __asm__ __volatile__("inb %1, %0" : "=a"(ret) : "Nd"(port));
+  return ret;
+}
+
+static void InitializeUART() {
+  WritePort(kUARTInterruptEnable, 0x00);
+  // Set the divisor latch access bit to program the baud rate.
+  WritePort(kUARTLineControl, 0x80);
+  WritePort(kUARTData, kUARTDivisor & 0xFF);
+  WritePort(kUARTInterruptEnable, kUARTDivisor >> 8);
+  // 8 data bits, no parity, 1 stop bit.
+  WritePort(kUARTLineControl, 0x03);
+  // Enable and clear the FIFOs.
+  WritePort(kUARTFIFOControl, 0xC7);
+  // Assert DTR and RTS.
+  WritePort(kUARTModemControl, 0x03);
+}
+
+static void WriteUART(const std::string &data) {
+  for (auto c : data) {
+    for (uint32_t i = 0; i < kMaxTransmitPolls && !(ReadPort(kUARTLineStatus) & kLineStatusTransmitterEmpty); ++i) {
+    }
+    WritePort(kUARTData, static_cast<uint8_t>(c));
+  }
+}
+
+static uint32_t CRC32(const std::string &data) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (auto c : data) {
+    crc ^= static_cast<uint8_t>(c);
+    for (auto bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+ResultStream::ResultStream(Transport transport) : transport_(transport) {
+  if (transport_ == Transport::SERIAL) {
+    InitializeUART();
+  }
+}
+
+void ResultStream::Send(const std::string &record) {
+  if (transport_ == Transport::NONE) {
+    return;
+  }
+
+  const auto crc = CRC32(record);
+  const auto num_chunks = std::max<uint32_t>(1, (record.size() + kMaxChunkSize - 1) / kMaxChunkSize);
+  char header[64];
+  for (uint32_t i = 0; i < num_chunks; ++i) {
+    snprintf(header, sizeof(header), "%s %lu %lu %lu %08lx ", kFrameMagic, sequence_, i, num_chunks, crc);
+    Write(header + record.substr(i * kMaxChunkSize, kMaxChunkSize) + "\n");
+  }
+  ++sequence_;
+}
+
+void ResultStream::Write(const std::string &frame) {
+  switch (transport_) {
+    case Transport::SERIAL:
+      WriteUART(frame);
+      break;
+    case Transport::DEBUG_PRINT:
+      DbgPrint("%s", frame.c_str());
+      break;
+    case Transport::NONE:
+      break;
+  }
+}
+
+const char *ResultStream::TransportName(Transport transport) {
+  switch (transport) {
+    case Transport::NONE:
+      return "none";
+    case Transport::SERIAL:
+      return "serial";
+    case Transport::DEBUG_PRINT:
+      return "debug_print";
+  }
+  return "unknown";
+}
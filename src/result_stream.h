@@ -0,0 +1,43 @@
+#ifndef XEMU_PERF_TESTS_RESULT_STREAM_H
+#define XEMU_PERF_TESTS_RESULT_STREAM_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Streams results records off the console as they are produced, so that they can be captured live on the host (see
+ * utils/capture_results.py).
+ *
+ * Each record is split into one or more line oriented frames of the form
+ *   @XPT1 <sequence> <chunk index> <chunk count> <crc32> <chunk>\n
+ * where <sequence> identifies the record, <crc32> is the 8 digit hexadecimal CRC-32 (IEEE) of the complete record, and
+ * the chunks of a record concatenate to the record itself. Records never contain newlines, so frames may be
+ * interleaved with other line oriented output (e.g., other DbgPrint messages) on the same channel.
+ */
+class ResultStream {
+ public:
+  enum class Transport {
+    NONE,
+    //! The first 16550 compatible UART (COM1), as emulated by xemu.
+    SERIAL,
+    //! Kernel debug output (DbgPrint).
+    DEBUG_PRINT,
+  };
+
+ public:
+  explicit ResultStream(Transport transport);
+
+  //! Sends the given single line record.
+  void Send(const std::string &record);
+
+  static const char *TransportName(Transport transport);
+
+ private:
+  void Write(const std::string &frame);
+
+ private:
+  Transport transport_;
+  uint32_t sequence_{0};
+};
+
+#endif  // XEMU_PERF_TESTS_RESULT_STREAM_H
@@ -1,43 +1,103 @@
 #include "runtime_config.h"
 
+#include <algorithm>
 #include <fstream>
-#include <list>
 
+#include "debug_output.h"
+#include "json_parser.h"
+#include "test_driver.h"
 #include "tiny-json.h"
 
 #define MAX_CONFIG_FILE_SIZE (1024 * 1024)
+// Upper bound on the number of values of a single swept parameter, guarding against accidentally huge ranges.
+#define MAX_SWEEP_VALUES 1024
+
+struct BuiltinProfile {
+  const char* name;
+  //! JSON object in the same format as an entry in the "profiles" section of the config file.
+  const char* config;
+};
+
+//! Profiles that may be selected without being defined in the "profiles" section of the config file.
+static constexpr BuiltinProfile kBuiltinProfiles[] = {
+    // A quick check that every test still runs, e.g., before merging a change. Each test is capped to a handful of
+    // iterations and a quarter of a second so that the full list completes in under a minute.
+    {"smoke", R"({
+      "settings": {
+        "delay_milliseconds_between_tests": 0,
+        "quiescence_vblanks": 1,
+        "warmup_iterations": 1,
+        "steady_state_window": 0,
+        "adaptive_target_precision_percent": 100,
+        "adaptive_min_iterations": 3,
+        "adaptive_max_iterations": 5,
+        "adaptive_time_budget_milliseconds": 250,
+        "calibrate_workloads": false,
+        "repeat_passes": 1,
+        "test_order": "sorted",
+        "write_checkpoints": false,
+        "resume_from_checkpoints": false,
+        "capture_framebuffers": false,
+        "trace_events": false,
+        "binary_raw_samples": false
+      }
+    })"},
+    // Tight error bars for tracking performance over time. Every test waits for steady state, iterates until its median
+    // is known to within 1%, and is repeated over several shuffled passes to decorrelate tests from slow drift.
+    {"nightly", R"({
+      "settings": {
+        "delay_milliseconds_between_tests": 250,
+        "quiescence_vblanks": 4,
+        "warmup_iterations": 3,
+        "steady_state_window": 10,
+        "steady_state_cv_threshold": 0.05,
+        "max_steady_state_iterations": 100,
+        "adaptive_target_precision_percent": 1,
+        "adaptive_min_iterations": 30,
+        "adaptive_max_iterations": 2000,
+        "adaptive_time_budget_milliseconds": 20000,
+        "calibrate_workloads": false,
+        "repeat_passes": 3,
+        "test_order": "random",
+        "write_checkpoints": true,
+        "resume_from_checkpoints": false,
+        "capture_framebuffers": true,
+        "trace_events": false,
+        "binary_raw_samples": true
+      }
+    })"},
+    // Long running stability check that exposes drift such as growing emulator caches or thermal throttling. Tests are
+    // interleaved over many passes so that each pass samples every suite at a different point in the run.
+    {"soak", R"({
+      "settings": {
+        "delay_milliseconds_between_tests": 0,
+        "quiescence_vblanks": 2,
+        "warmup_iterations": 1,
+        "steady_state_window": 0,
+        "adaptive_target_precision_percent": 2,
+        "adaptive_min_iterations": 10,
+        "adaptive_max_iterations": 500,
+        "adaptive_time_budget_milliseconds": 5000,
+        "calibrate_workloads": false,
+        "repeat_passes": 20,
+        "test_order": "interleaved",
+        "write_checkpoints": true,
+        "resume_from_checkpoints": false,
+        "capture_framebuffers": false,
+        "trace_events": false,
+        "binary_raw_samples": true
+      }
+    })"},
+};
 
 static bool ParseTestSuites(
     json_t const* test_suites, std::vector<std::string>& errors,
     std::map<std::string, RuntimeConfig::SkipConfiguration>& skipped_test_suites,
-    std::map<std::string, std::map<std::string, RuntimeConfig::SkipConfiguration>>& skipped_test_cases);
-
-//! C++ wrapper around Tiny-JSON jsonPool_t
-class JSONParser : jsonPool_t {
- public:
-  JSONParser() : jsonPool_t{&Alloc, &Alloc} {}
-  explicit JSONParser(const char* str) : jsonPool_t{&Alloc, &Alloc}, json_string_{str} {
-    root_node_ = json_createWithPool(json_string_.data(), this);
-  }
-
-  JSONParser(const JSONParser&) = delete;
-  JSONParser(JSONParser&&) = delete;
-  JSONParser& operator=(const JSONParser&) = delete;
-  JSONParser& operator=(JSONParser&&) = delete;
-
-  [[nodiscard]] json_t const* root() const { return root_node_; }
-
- private:
-  static json_t* Alloc(jsonPool_t* pool) {
-    const auto list_pool = static_cast<JSONParser*>(pool);
-    list_pool->object_list_.emplace_back();
-    return &list_pool->object_list_.back();
-  }
-
-  std::list<json_t> object_list_{};
-  std::string json_string_{};
-  json_t const* root_node_{};
-};
+    std::map<std::string, std::map<std::string, RuntimeConfig::SkipConfiguration>>& skipped_test_cases,
+    std::map<std::string, TestSuite::TunableValues>& suite_tunables,
+    std::map<std::string, std::map<std::string, TestSuite::TunableValues>>& test_tunables,
+    std::map<std::string, std::map<std::string, std::vector<uint32_t>>>& sweeps, RuntimeConfig::TestFilter& test_filter,
+    std::map<std::string, RuntimeConfig::TestFilter>& suite_filters);
 
 bool RuntimeConfig::LoadConfig(const char* config_file_path, std::vector<std::string>& errors) {
   std::string dos_style_path = config_file_path;
@@ -69,6 +129,11 @@ bool RuntimeConfig::LoadConfig(const char* config_file_path, std::vector<std::st
   return LoadConfigBuffer(json_string, errors);
 }
 
+bool RuntimeConfig::LoadDefaultConfig(std::vector<std::string>& errors) {
+  profile_ = DEFAULT_RUNTIME_PROFILE;
+  return LoadConfigBuffer(R"({"settings": {}})", errors);
+}
+
 static bool LoadBool(json_t const* object, const char* key, bool& out) {
   auto property = json_getProperty(object, key);
   if (!property) {
@@ -116,27 +181,26 @@ static bool LoadUint32(json_t const* object, const char* key, uint32_t& out) {
   return true;
 };
 
-bool RuntimeConfig::LoadConfigBuffer(const std::string& config_content, std::vector<std::string>& errors) {
-  std::map<std::string, std::vector<std::string>> test_config;
-
-  const JSONParser parser{config_content.c_str()};
-
-  auto root = parser.root();
-  if (!root) {
-    errors.emplace_back("Failed to parse config file.");
-    return false;
+static bool LoadFloat(json_t const* object, const char* key, float& out) {
+  auto property = json_getProperty(object, key);
+  if (!property) {
+    return true;
   }
 
-  auto settings = json_getProperty(root, "settings");
-  if (!settings) {
-    errors.emplace_back("'settings' not found");
-    return false;
+  auto type = json_getType(property);
+  if (type == JSON_REAL) {
+    out = static_cast<float>(json_getReal(property));
+    return true;
   }
-  if (json_getType(settings) != JSON_OBJ) {
-    errors.emplace_back("'settings' not an object");
-    return false;
+  if (type == JSON_INTEGER) {
+    out = static_cast<float>(json_getInteger(property));
+    return true;
   }
 
+  return false;
+};
+
+bool RuntimeConfig::LoadSettings(json_t const* settings, std::vector<std::string>& errors) {
   if (!LoadBool(settings, "disable_autorun", disable_autorun_)) {
     errors.emplace_back("settings[disable_autorun] must be a boolean");
     return false;
@@ -157,6 +221,16 @@ bool RuntimeConfig::LoadConfigBuffer(const std::string& config_content, std::vec
     return false;
   }
 
+  if (!LoadUint32(settings, "delay_milliseconds_between_tests", suite_config_.delay_milliseconds_between_tests)) {
+    errors.emplace_back("settings[delay_milliseconds_between_tests] must be an integer");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "quiescence_vblanks", suite_config_.quiescence_vblanks)) {
+    errors.emplace_back("settings[quiescence_vblanks] must be an integer");
+    return false;
+  }
+
   if (!LoadString(settings, "output_directory_path", output_directory_path_)) {
     errors.emplace_back("settings[output_directory_path] must be a string");
     return false;
@@ -168,7 +242,282 @@ bool RuntimeConfig::LoadConfigBuffer(const std::string& config_content, std::vec
     return false;
   }
 
+  if (!LoadBool(settings, "buffer_results_in_memory", buffer_results_in_memory_)) {
+    errors.emplace_back("settings[buffer_results_in_memory] must be a boolean");
+    return false;
+  }
+
+  if (!LoadBool(settings, "binary_raw_samples", binary_raw_samples_)) {
+    errors.emplace_back("settings[binary_raw_samples] must be a boolean");
+    return false;
+  }
+
+  {
+    std::string stream_results;
+    if (!LoadString(settings, "stream_results", stream_results)) {
+      errors.emplace_back("settings[stream_results] must be a string");
+      return false;
+    }
+    if (stream_results == "none") {
+      stream_results_ = ResultStream::Transport::NONE;
+    } else if (stream_results == "serial") {
+      stream_results_ = ResultStream::Transport::SERIAL;
+    } else if (stream_results == "debug_print") {
+      stream_results_ = ResultStream::Transport::DEBUG_PRINT;
+    } else if (!stream_results.empty()) {
+      errors.emplace_back("settings[stream_results] must be one of 'none', 'serial', or 'debug_print'");
+      return false;
+    }
+  }
+
+  {
+    std::string timing_mode;
+    if (!LoadString(settings, "timing_mode", timing_mode)) {
+      errors.emplace_back("settings[timing_mode] must be a string");
+      return false;
+    }
+    if (timing_mode == "submit") {
+      timing_mode_ = TestHost::TimingMode::SUBMIT;
+    } else if (timing_mode == "gpu_completion") {
+      timing_mode_ = TestHost::TimingMode::GPU_COMPLETION;
+    } else if (!timing_mode.empty()) {
+      errors.emplace_back("settings[timing_mode] must be one of 'submit' or 'gpu_completion'");
+      return false;
+    }
+  }
+
+  {
+    std::string timer_source;
+    if (!LoadString(settings, "timer_source", timer_source)) {
+      errors.emplace_back("settings[timer_source] must be a string");
+      return false;
+    }
+    if (timer_source == "qpc") {
+      timer_source_ = TestHost::TimerSource::PERFORMANCE_COUNTER;
+    } else if (timer_source == "rdtsc") {
+      timer_source_ = TestHost::TimerSource::RDTSC;
+    } else if (!timer_source.empty()) {
+      errors.emplace_back("settings[timer_source] must be one of 'qpc' or 'rdtsc'");
+      return false;
+    }
+  }
+
+  if (!LoadUint32(settings, "warmup_iterations", suite_config_.warmup_iterations)) {
+    errors.emplace_back("settings[warmup_iterations] must be an integer");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "steady_state_window", suite_config_.steady_state_window)) {
+    errors.emplace_back("settings[steady_state_window] must be an integer");
+    return false;
+  }
+
+  if (!LoadFloat(settings, "steady_state_cv_threshold", suite_config_.steady_state_cv_threshold)) {
+    errors.emplace_back("settings[steady_state_cv_threshold] must be a number");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "max_steady_state_iterations", suite_config_.max_steady_state_iterations)) {
+    errors.emplace_back("settings[max_steady_state_iterations] must be an integer");
+    return false;
+  }
+
+  if (!LoadFloat(settings, "adaptive_target_precision_percent", suite_config_.adaptive_target_precision_percent)) {
+    errors.emplace_back("settings[adaptive_target_precision_percent] must be a number");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "adaptive_min_iterations", suite_config_.adaptive_min_iterations)) {
+    errors.emplace_back("settings[adaptive_min_iterations] must be an integer");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "adaptive_max_iterations", suite_config_.adaptive_max_iterations)) {
+    errors.emplace_back("settings[adaptive_max_iterations] must be an integer");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "adaptive_time_budget_milliseconds", suite_config_.adaptive_time_budget_milliseconds)) {
+    errors.emplace_back("settings[adaptive_time_budget_milliseconds] must be an integer");
+    return false;
+  }
+
+  if (!LoadBool(settings, "subtract_harness_overhead", suite_config_.subtract_harness_overhead)) {
+    errors.emplace_back("settings[subtract_harness_overhead] must be a boolean");
+    return false;
+  }
+
+  if (!LoadBool(settings, "calibrate_workloads", suite_config_.calibrate_workloads)) {
+    errors.emplace_back("settings[calibrate_workloads] must be a boolean");
+    return false;
+  }
+
+  if (!LoadFloat(settings, "calibration_target_frame_time_milliseconds",
+                 suite_config_.calibration_target_frame_time_milliseconds)) {
+    errors.emplace_back("settings[calibration_target_frame_time_milliseconds] must be a number");
+    return false;
+  }
+  if (suite_config_.calibration_target_frame_time_milliseconds <= 0.f) {
+    errors.emplace_back("settings[calibration_target_frame_time_milliseconds] must be greater than 0");
+    return false;
+  }
+
+  if (!LoadUint32(settings, "repeat_passes", repeat_passes_)) {
+    errors.emplace_back("settings[repeat_passes] must be an integer");
+    return false;
+  }
+  if (!repeat_passes_) {
+    errors.emplace_back("settings[repeat_passes] must be greater than 0");
+    return false;
+  }
+
+  {
+    std::string test_order;
+    if (!LoadString(settings, "test_order", test_order)) {
+      errors.emplace_back("settings[test_order] must be a string");
+      return false;
+    }
+    if (test_order == "sorted") {
+      test_order_ = TestOrder::SORTED;
+    } else if (test_order == "random") {
+      test_order_ = TestOrder::RANDOM;
+    } else if (test_order == "interleaved") {
+      test_order_ = TestOrder::INTERLEAVED;
+    } else if (!test_order.empty()) {
+      errors.emplace_back("settings[test_order] must be one of 'sorted', 'random', or 'interleaved'");
+      return false;
+    }
+  }
+
+  if (!LoadUint32(settings, "random_seed", random_seed_)) {
+    errors.emplace_back("settings[random_seed] must be an integer");
+    return false;
+  }
+
+  if (!LoadBool(settings, "write_checkpoints", write_checkpoints_)) {
+    errors.emplace_back("settings[write_checkpoints] must be a boolean");
+    return false;
+  }
+
+  if (!LoadBool(settings, "resume_from_checkpoints", resume_from_checkpoints_)) {
+    errors.emplace_back("settings[resume_from_checkpoints] must be a boolean");
+    return false;
+  }
+
+  if (!LoadBool(settings, "capture_framebuffers", capture_framebuffers_)) {
+    errors.emplace_back("settings[capture_framebuffers] must be a boolean");
+    return false;
+  }
+
+  if (!LoadBool(settings, "trace_events", trace_events_)) {
+    errors.emplace_back("settings[trace_events] must be a boolean");
+    return false;
+  }
+  if (!LoadBool(settings, "dry_run", dry_run_)) {
+    errors.emplace_back("settings[dry_run] must be a boolean");
+    return false;
+  }
+
+  return true;
+}
+
+bool RuntimeConfig::LoadConfigBuffer(const std::string& config_content, std::vector<std::string>& errors) {
+  std::map<std::string, std::vector<std::string>> test_config;
+
+  const JSONParser parser{config_content.c_str()};
+
+  auto root = parser.root();
+  if (!root) {
+    errors.emplace_back("Failed to parse config file.");
+    return false;
+  }
+
+  auto settings = json_getProperty(root, "settings");
+  if (!settings) {
+    errors.emplace_back("'settings' not found");
+    return false;
+  }
+  if (json_getType(settings) != JSON_OBJ) {
+    errors.emplace_back("'settings' not an object");
+    return false;
+  }
+
+  {
+    // An empty profile defers to the compile-time default.
+    std::string profile;
+    if (!LoadString(settings, "profile", profile)) {
+      errors.emplace_back("settings[profile] must be a string");
+      return false;
+    }
+    if (!profile.empty()) {
+      profile_ = profile;
+    }
+  }
+
   auto test_suites = json_getProperty(root, "test_suites");
+
+  // Settings are applied from the built in profile of the selected name (if any), then from the profile of that name in
+  // the config file (if any), and finally from the base settings, so that explicitly set values always take
+  // precedence. The test selection of a profile (if any) replaces the base selection entirely.
+  JSONParser builtin_profile_parser;
+  if (!profile_.empty()) {
+    json_t const* builtin_profile = nullptr;
+    auto builtin = std::find_if(std::begin(kBuiltinProfiles), std::end(kBuiltinProfiles),
+                                [this](const BuiltinProfile& entry) { return profile_ == entry.name; });
+    if (builtin != std::end(kBuiltinProfiles)) {
+      builtin_profile_parser.Parse(builtin->config);
+      builtin_profile = builtin_profile_parser.root();
+      ASSERT(builtin_profile && "Failed to parse built in profile");
+    }
+
+    json_t const* user_profile = nullptr;
+    auto profiles = json_getProperty(root, "profiles");
+    if (profiles) {
+      if (json_getType(profiles) != JSON_OBJ) {
+        errors.emplace_back("'profiles' not an object");
+        return false;
+      }
+      user_profile = json_getProperty(profiles, profile_.c_str());
+    }
+
+    if (!builtin_profile && !user_profile) {
+      errors.emplace_back("settings[profile] '" + profile_ + "' is not defined in 'profiles' or built in");
+      return false;
+    }
+
+    const auto profile_error_message_prefix = "profiles[" + profile_ + "]";
+    for (auto profile : {builtin_profile, user_profile}) {
+      if (!profile) {
+        continue;
+      }
+      if (json_getType(profile) != JSON_OBJ) {
+        errors.emplace_back(profile_error_message_prefix + " must be an object");
+        return false;
+      }
+
+      auto profile_settings = json_getProperty(profile, "settings");
+      if (profile_settings) {
+        if (json_getType(profile_settings) != JSON_OBJ) {
+          errors.emplace_back(profile_error_message_prefix + "[settings] must be an object");
+          return false;
+        }
+        if (!LoadSettings(profile_settings, errors)) {
+          errors.emplace_back("Failed to apply " + profile_error_message_prefix);
+          return false;
+        }
+      }
+
+      auto profile_test_suites = json_getProperty(profile, "test_suites");
+      if (profile_test_suites) {
+        test_suites = profile_test_suites;
+      }
+    }
+  }
+
+  if (!LoadSettings(settings, errors)) {
+    return false;
+  }
+
   if (!test_suites) {
     return true;
   }
@@ -178,7 +527,9 @@ bool RuntimeConfig::LoadConfigBuffer(const std::string& config_content, std::vec
     return false;
   }
 
-  return ParseTestSuites(test_suites, errors, configured_test_suites_, configured_test_cases_);
+  return ParseTestSuites(test_suites, errors, configured_test_suites_, configured_test_cases_,
+                         configured_suite_tunables_, configured_test_tunables_, configured_sweeps_, test_filter_,
+                         configured_suite_filters_);
 }
 
 static RuntimeConfig::SkipConfiguration MakeSkipConfiguration(bool is_skipped) {
@@ -188,13 +539,169 @@ static RuntimeConfig::SkipConfiguration MakeSkipConfiguration(bool is_skipped) {
   return RuntimeConfig::SkipConfiguration::UNSKIPPED;
 }
 
+static bool ParseTunable(json_t const* element, TestSuite::Tunable tunable, TestSuite::TunableValues& values,
+                         std::vector<std::string>& errors, const std::string& error_message_prefix) {
+  if (json_getType(element) != JSON_INTEGER || json_getInteger(element) <= 0 ||
+      json_getInteger(element) > UINT32_MAX) {
+    errors.emplace_back(error_message_prefix + "[" + TestSuite::TunableName(tunable) + "] must be a positive integer");
+    return false;
+  }
+
+  values[tunable] = static_cast<uint32_t>(json_getInteger(element));
+  return true;
+}
+
+static bool ParseSweep(json_t const* element, std::vector<uint32_t>& values, std::vector<std::string>& errors,
+                       const std::string& error_message_prefix) {
+  auto type = json_getType(element);
+  if (type == JSON_ARRAY) {
+    for (auto value = json_getChild(element); value; value = json_getSibling(value)) {
+      if (json_getType(value) != JSON_INTEGER || json_getInteger(value) <= 0 || json_getInteger(value) > UINT32_MAX) {
+        errors.emplace_back(error_message_prefix + " must contain only positive integers");
+        return false;
+      }
+      values.push_back(static_cast<uint32_t>(json_getInteger(value)));
+    }
+  } else if (type == JSON_OBJ) {
+    uint32_t start = 0;
+    uint32_t stop = 0;
+    uint32_t step = 0;
+    uint32_t factor = 0;
+    if (!LoadUint32(element, "start", start) || !LoadUint32(element, "stop", stop) ||
+        !LoadUint32(element, "step", step) || !LoadUint32(element, "factor", factor)) {
+      errors.emplace_back(error_message_prefix + " range values must be non-negative integers");
+      return false;
+    }
+    if (!start || stop < start || (!step == !factor)) {
+      errors.emplace_back(error_message_prefix +
+                          " must specify a positive start, a stop no smaller than start, and one of step or factor");
+      return false;
+    }
+    if (factor == 1) {
+      errors.emplace_back(error_message_prefix + "[factor] must be greater than 1");
+      return false;
+    }
+    if (step && (stop - start) / step >= MAX_SWEEP_VALUES) {
+      errors.emplace_back(error_message_prefix + " must not produce more than " + std::to_string(MAX_SWEEP_VALUES) +
+                          " values");
+      return false;
+    }
+    values = step ? TestSuite::LinearRange(start, stop, step) : TestSuite::GeometricRange(start, stop, factor);
+  } else {
+    errors.emplace_back(error_message_prefix + " must be an array or a range object");
+    return false;
+  }
+
+  if (values.empty() || values.size() > MAX_SWEEP_VALUES) {
+    errors.emplace_back(error_message_prefix + " must contain between 1 and " + std::to_string(MAX_SWEEP_VALUES) +
+                        " values");
+    return false;
+  }
+  return true;
+}
+
+static bool ParseSweeps(json_t const* sweeps, std::map<std::string, std::vector<uint32_t>>& suite_sweeps,
+                        std::vector<std::string>& errors, const std::string& error_message_prefix) {
+  if (json_getType(sweeps) != JSON_OBJ) {
+    errors.emplace_back(error_message_prefix + " must be an object");
+    return false;
+  }
+
+  for (auto element = json_getChild(sweeps); element; element = json_getSibling(element)) {
+    std::string name = json_getName(element);
+    std::vector<uint32_t> values;
+    if (!ParseSweep(element, values, errors, error_message_prefix + "[" + name + "]")) {
+      return false;
+    }
+    suite_sweeps[name] = values;
+  }
+  return true;
+}
+
+//! Parses a pattern or array of patterns.
+static bool ParsePatterns(json_t const* element, std::vector<TestPattern>& patterns, std::vector<std::string>& errors,
+                          const std::string& error_message_prefix) {
+  auto parse = [&patterns, &errors](json_t const* pattern_element, const std::string& error_prefix) {
+    if (json_getType(pattern_element) != JSON_TEXT) {
+      errors.emplace_back(error_prefix + " must be a string");
+      return false;
+    }
+    TestPattern pattern;
+    std::string error;
+    if (!pattern.Parse(json_getValue(pattern_element), error)) {
+      errors.emplace_back(error_prefix + " '" + json_getValue(pattern_element) + "' is invalid: " + error);
+      return false;
+    }
+    patterns.push_back(std::move(pattern));
+    return true;
+  };
+
+  if (json_getType(element) != JSON_ARRAY) {
+    return parse(element, error_message_prefix);
+  }
+
+  uint32_t index = 0;
+  for (auto pattern = json_getChild(element); pattern; pattern = json_getSibling(pattern), ++index) {
+    if (!parse(pattern, error_message_prefix + "[" + std::to_string(index) + "]")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//! Patterns that matched at least one test name, and those that were abandoned for backtracking excessively.
+struct PatternMatches {
+  std::set<const TestPattern*> matched;
+  std::set<const TestPattern*> exceeded_step_limit;
+};
+
+//! Returns true if any of the given patterns match the given name. Every pattern is evaluated so that `matches`
+//! records each one that matched.
+static bool MatchesAny(const std::vector<TestPattern>& patterns, const std::string& name, PatternMatches& matches) {
+  bool ret = false;
+  for (auto& pattern : patterns) {
+    if (pattern.Matches(name)) {
+      matches.matched.insert(&pattern);
+      ret = true;
+    } else if (pattern.ExceededStepLimit()) {
+      matches.exceeded_step_limit.insert(&pattern);
+    }
+  }
+  return ret;
+}
+
+//! Reports an error for each of the given patterns that did not match any test name.
+static bool CheckPatternsMatched(const std::vector<TestPattern>& patterns, const PatternMatches& matches,
+                                 std::vector<std::string>& errors, const std::string& error_message_prefix) {
+  bool ret = true;
+  for (auto& pattern : patterns) {
+    if (matches.exceeded_step_limit.count(&pattern)) {
+      errors.emplace_back(error_message_prefix + " '" + pattern.Source() +
+                          "' backtracks excessively, consider simplifying it");
+      ret = false;
+    } else if (!matches.matched.count(&pattern)) {
+      errors.emplace_back(error_message_prefix + " '" + pattern.Source() + "' does not match any test");
+      ret = false;
+    }
+  }
+  return ret;
+}
+
 static bool ParseTestCase(json_t const* test_case, const std::string& suite_name, const std::string& test_name,
                           std::vector<std::string>& errors, RuntimeConfig::SkipConfiguration& config_value,
-                          const std::string& test_case_error_message_prefix) {
+                          TestSuite::TunableValues& tunables, const std::string& test_case_error_message_prefix) {
   for (auto element = json_getChild(test_case); element; element = json_getSibling(element)) {
     std::string name = json_getName(element);
     auto type = json_getType(element);
 
+    TestSuite::Tunable tunable;
+    if (TestSuite::ParseTunableName(name, tunable)) {
+      if (!ParseTunable(element, tunable, tunables, errors, test_case_error_message_prefix)) {
+        return false;
+      }
+      continue;
+    }
+
     if (name != "skipped") {
       errors.emplace_back(test_case_error_message_prefix + "[" + name + "] unsupported. Ignoring");
       continue;
@@ -215,8 +722,12 @@ static bool ParseTestCases(
     json_t const* test_suite, const std::string& suite_name, std::vector<std::string>& errors,
     std::map<std::string, RuntimeConfig::SkipConfiguration>& configured_suites,
     std::map<std::string, std::map<std::string, RuntimeConfig::SkipConfiguration>>& configured_cases,
+    std::map<std::string, TestSuite::TunableValues>& suite_tunables,
+    std::map<std::string, std::map<std::string, TestSuite::TunableValues>>& test_tunables,
+    std::map<std::string, std::map<std::string, std::vector<uint32_t>>>& sweeps, RuntimeConfig::TestFilter& filter,
     const std::string& suite_error_message_prefix) {
   std::map<std::string, RuntimeConfig::SkipConfiguration> case_settings;
+  std::map<std::string, TestSuite::TunableValues> case_tunables;
 
   for (auto test_or_skipped = json_getChild(test_suite); test_or_skipped;
        test_or_skipped = json_getSibling(test_or_skipped)) {
@@ -233,15 +744,42 @@ static bool ParseTestCases(
       return false;
     }
 
+    if (test_name == "include" || test_name == "exclude") {
+      auto& patterns = test_name == "include" ? filter.include : filter.exclude;
+      if (!ParsePatterns(test_or_skipped, patterns, errors, suite_error_message_prefix + "[" + test_name + "]")) {
+        return false;
+      }
+      continue;
+    }
+
+    if (test_name == "sweeps") {
+      if (!ParseSweeps(test_or_skipped, sweeps[suite_name], errors, suite_error_message_prefix + "[sweeps]")) {
+        return false;
+      }
+      continue;
+    }
+
+    TestSuite::Tunable tunable;
+    if (TestSuite::ParseTunableName(test_name, tunable)) {
+      if (!ParseTunable(test_or_skipped, tunable, suite_tunables[suite_name], errors, suite_error_message_prefix)) {
+        return false;
+      }
+      continue;
+    }
+
     if (type == JSON_OBJ) {
       auto config_value = RuntimeConfig::SkipConfiguration::DEFAULT;
-      if (!ParseTestCase(test_or_skipped, suite_name, test_name, errors, config_value,
+      TestSuite::TunableValues tunables;
+      if (!ParseTestCase(test_or_skipped, suite_name, test_name, errors, config_value, tunables,
                          suite_error_message_prefix + "[" + test_name + "]")) {
         return false;
       }
       if (config_value != RuntimeConfig::SkipConfiguration::DEFAULT) {
         case_settings[test_name] = config_value;
       }
+      if (!tunables.empty()) {
+        case_tunables[test_name] = tunables;
+      }
     } else {
       errors.emplace_back(suite_error_message_prefix + "[" + test_name + "] must be an object. Ignoring");
       continue;
@@ -251,6 +789,9 @@ static bool ParseTestCases(
   if (!case_settings.empty()) {
     configured_cases[suite_name] = case_settings;
   }
+  if (!case_tunables.empty()) {
+    test_tunables[suite_name] = case_tunables;
+  }
 
   return true;
 }
@@ -258,21 +799,37 @@ static bool ParseTestCases(
 static bool ParseTestSuites(
     json_t const* test_suites, std::vector<std::string>& errors,
     std::map<std::string, RuntimeConfig::SkipConfiguration>& skipped_test_suites,
-    std::map<std::string, std::map<std::string, RuntimeConfig::SkipConfiguration>>& skipped_test_cases) {
+    std::map<std::string, std::map<std::string, RuntimeConfig::SkipConfiguration>>& skipped_test_cases,
+    std::map<std::string, TestSuite::TunableValues>& suite_tunables,
+    std::map<std::string, std::map<std::string, TestSuite::TunableValues>>& test_tunables,
+    std::map<std::string, std::map<std::string, std::vector<uint32_t>>>& sweeps, RuntimeConfig::TestFilter& test_filter,
+    std::map<std::string, RuntimeConfig::TestFilter>& suite_filters) {
   std::string test_suites_error_message_prefix("test_suites[");
   for (auto suite = json_getChild(test_suites); suite; suite = json_getSibling(suite)) {
     std::string suite_name = json_getName(suite);
     auto suite_error_message_prefix = test_suites_error_message_prefix + suite_name + "]";
 
+    if (suite_name == "include" || suite_name == "exclude") {
+      auto& patterns = suite_name == "include" ? test_filter.include : test_filter.exclude;
+      if (!ParsePatterns(suite, patterns, errors, suite_error_message_prefix)) {
+        return false;
+      }
+      continue;
+    }
+
     if (json_getType(suite) != JSON_OBJ) {
       errors.emplace_back(suite_error_message_prefix + " must be an object. Ignoring");
       continue;
     }
 
-    if (!ParseTestCases(suite, suite_name, errors, skipped_test_suites, skipped_test_cases,
-                        suite_error_message_prefix)) {
+    RuntimeConfig::TestFilter suite_filter;
+    if (!ParseTestCases(suite, suite_name, errors, skipped_test_suites, skipped_test_cases, suite_tunables,
+                        test_tunables, sweeps, suite_filter, suite_error_message_prefix)) {
       return false;
     }
+    if (!suite_filter.include.empty() || !suite_filter.exclude.empty()) {
+      suite_filters[suite_name] = suite_filter;
+    }
   }
 
   return true;
@@ -281,15 +838,24 @@ static bool ParseTestSuites(
 bool RuntimeConfig::ApplyConfig(std::vector<std::shared_ptr<TestSuite>>& test_suites,
                                 std::vector<std::string>& errors) {
   std::vector<std::shared_ptr<TestSuite>> filtered_test_suites;
+  PatternMatches pattern_matches;
 
   for (auto& suite : test_suites) {
+    // Sweeps change the set of test names, so they must be applied before tests are filtered.
+    auto sweeps = configured_sweeps_.find(suite->Name());
+    if (sweeps != configured_sweeps_.end() && !suite->SetSweepOverrides(sweeps->second, errors)) {
+      return false;
+    }
+
     auto default_skip_test_case = skip_tests_by_default_;
+    bool suite_explicitly_skipped = false;
 
     auto entry = configured_test_suites_.find(suite->Name());
     if (entry != configured_test_suites_.end()) {
       switch (entry->second) {
         case SkipConfiguration::SKIPPED:
           default_skip_test_case = true;
+          suite_explicitly_skipped = true;
           break;
         case SkipConfiguration::UNSKIPPED:
           default_skip_test_case = false;
@@ -302,9 +868,31 @@ bool RuntimeConfig::ApplyConfig(std::vector<std::shared_ptr<TestSuite>>& test_su
     auto test_case_config = configured_test_cases_.find(suite->Name());
     std::set<std::string> skipped_test_cases;
 
+    static const TestFilter kEmptyFilter;
+    auto suite_filter_entry = configured_suite_filters_.find(suite->Name());
+    const auto& suite_filter =
+        suite_filter_entry == configured_suite_filters_.end() ? kEmptyFilter : suite_filter_entry->second;
+    // Global include patterns do not apply to a suite that is explicitly skipped, only its own patterns may select
+    // tests from it.
+    const bool has_include_patterns =
+        (!suite_explicitly_skipped && !test_filter_.include.empty()) || !suite_filter.include.empty();
+
     for (auto& test_case : suite->TestNames()) {
       bool skip_test_case = default_skip_test_case;
 
+      // Patterns take precedence over the default, and are overridden by an explicit "skipped" for the test case.
+      const auto full_name = suite->Name() + "::" + test_case;
+      const bool matches_global_include = MatchesAny(test_filter_.include, full_name, pattern_matches);
+      const bool matches_suite_include = MatchesAny(suite_filter.include, test_case, pattern_matches);
+      if (has_include_patterns) {
+        skip_test_case = !(matches_global_include && !suite_explicitly_skipped) && !matches_suite_include;
+      }
+      const bool matches_global_exclude = MatchesAny(test_filter_.exclude, full_name, pattern_matches);
+      const bool matches_suite_exclude = MatchesAny(suite_filter.exclude, test_case, pattern_matches);
+      if (matches_global_exclude || matches_suite_exclude) {
+        skip_test_case = true;
+      }
+
       if (test_case_config != configured_test_cases_.end()) {
         auto explicit_config = test_case_config->second.find(test_case);
         if (explicit_config != test_case_config->second.end()) {
@@ -321,16 +909,181 @@ bool RuntimeConfig::ApplyConfig(std::vector<std::shared_ptr<TestSuite>>& test_su
       suite->DisableTests(skipped_test_cases);
     }
 
+    auto suite_tunables = configured_suite_tunables_.find(suite->Name());
+    auto test_tunables = configured_test_tunables_.find(suite->Name());
+    if (!suite->SetTunableOverrides(
+            suite_tunables == configured_suite_tunables_.end() ? TestSuite::TunableValues{} : suite_tunables->second,
+            test_tunables == configured_test_tunables_.end() ? std::map<std::string, TestSuite::TunableValues>{}
+                                                             : test_tunables->second,
+            errors)) {
+      return false;
+    }
+
     if (suite->HasEnabledTests()) {
       filtered_test_suites.push_back(suite);
     }
   }
 
+  // A pattern that matches nothing is most likely a typo, which would otherwise silently produce an unexpected run.
+  bool patterns_matched = CheckPatternsMatched(test_filter_.include, pattern_matches, errors, "test_suites[include]");
+  patterns_matched &= CheckPatternsMatched(test_filter_.exclude, pattern_matches, errors, "test_suites[exclude]");
+  for (auto& suite_filter : configured_suite_filters_) {
+    const auto error_message_prefix = "test_suites[" + suite_filter.first + "]";
+    patterns_matched &= CheckPatternsMatched(suite_filter.second.include, pattern_matches, errors,
+                                             error_message_prefix + "[include]");
+    patterns_matched &= CheckPatternsMatched(suite_filter.second.exclude, pattern_matches, errors,
+                                             error_message_prefix + "[exclude]");
+  }
+  if (!patterns_matched) {
+    return false;
+  }
+
   test_suites = filtered_test_suites;
 
   return true;
 }
 
+void RuntimeConfig::WriteSettings(JsonWriter& writer) const {
+  writer.BeginObject("settings");
+  writer.Add("disable_autorun", disable_autorun_);
+  writer.Add("enable_autorun_immediately", enable_autorun_immediately_);
+  writer.Add("enable_shutdown_on_completion", enable_shutdown_on_completion_);
+  writer.Add("skip_tests_by_default", skip_tests_by_default_);
+  writer.Add("delay_milliseconds_between_tests", suite_config_.delay_milliseconds_between_tests);
+  writer.Add("quiescence_vblanks", suite_config_.quiescence_vblanks);
+  writer.Add("output_directory_path", output_directory_path_);
+  writer.Add("reboot_or_shutdown_delay", reboot_or_shutdown_delay_ms_);
+  writer.Add("buffer_results_in_memory", buffer_results_in_memory_);
+  writer.Add("binary_raw_samples", binary_raw_samples_);
+  writer.Add("stream_results", ResultStream::TransportName(stream_results_));
+  writer.Add("timing_mode", TestHost::TimingModeName(timing_mode_));
+  writer.Add("timer_source", TestHost::TimerSourceName(timer_source_));
+  writer.Add("warmup_iterations", suite_config_.warmup_iterations);
+  writer.Add("steady_state_window", suite_config_.steady_state_window);
+  writer.Add("steady_state_cv_threshold", static_cast<double>(suite_config_.steady_state_cv_threshold));
+  writer.Add("max_steady_state_iterations", suite_config_.max_steady_state_iterations);
+  writer.Add("adaptive_target_precision_percent",
+             static_cast<double>(suite_config_.adaptive_target_precision_percent));
+  writer.Add("adaptive_min_iterations", suite_config_.adaptive_min_iterations);
+  writer.Add("adaptive_max_iterations", suite_config_.adaptive_max_iterations);
+  writer.Add("adaptive_time_budget_milliseconds", suite_config_.adaptive_time_budget_milliseconds);
+  writer.Add("subtract_harness_overhead", suite_config_.subtract_harness_overhead);
+  writer.Add("calibrate_workloads", suite_config_.calibrate_workloads);
+  writer.Add("calibration_target_frame_time_milliseconds",
+             static_cast<double>(suite_config_.calibration_target_frame_time_milliseconds));
+  writer.Add("repeat_passes", repeat_passes_);
+  writer.Add("test_order", TestDriver::TestOrderName(test_order_));
+  writer.Add("random_seed", random_seed_);
+  writer.Add("write_checkpoints", write_checkpoints_);
+  writer.Add("resume_from_checkpoints", resume_from_checkpoints_);
+  writer.Add("capture_framebuffers", capture_framebuffers_);
+  writer.Add("trace_events", trace_events_);
+  writer.Add("dry_run", dry_run_);
+  writer.EndObject();
+
+  auto write_skip_configuration = [&writer](SkipConfiguration skip_configuration) {
+    if (skip_configuration != SkipConfiguration::DEFAULT) {
+      writer.Add("skipped", skip_configuration == SkipConfiguration::SKIPPED);
+    }
+  };
+  auto write_tunables = [&writer](const TestSuite::TunableValues& tunables) {
+    for (auto& entry : tunables) {
+      writer.Add(TestSuite::TunableName(entry.first), entry.second);
+    }
+  };
+  auto write_filter = [&writer](const TestFilter& filter) {
+    auto write_patterns = [&writer](const char* key, const std::vector<TestPattern>& patterns) {
+      if (patterns.empty()) {
+        return;
+      }
+      writer.BeginArray(key);
+      for (auto& pattern : patterns) {
+        writer.Add(nullptr, pattern.Source());
+      }
+      writer.EndArray();
+    };
+    write_patterns("include", filter.include);
+    write_patterns("exclude", filter.exclude);
+  };
+
+  writer.BeginObject("test_suites");
+  write_filter(test_filter_);
+  std::set<std::string> suite_names;
+  for (auto& entry : configured_test_suites_) {
+    suite_names.insert(entry.first);
+  }
+  for (auto& entry : configured_test_cases_) {
+    suite_names.insert(entry.first);
+  }
+  for (auto& entry : configured_suite_tunables_) {
+    suite_names.insert(entry.first);
+  }
+  for (auto& entry : configured_test_tunables_) {
+    suite_names.insert(entry.first);
+  }
+  for (auto& entry : configured_sweeps_) {
+    suite_names.insert(entry.first);
+  }
+  for (auto& entry : configured_suite_filters_) {
+    suite_names.insert(entry.first);
+  }
+  for (auto& suite_name : suite_names) {
+    writer.BeginObject(suite_name.c_str());
+    auto suite_entry = configured_test_suites_.find(suite_name);
+    if (suite_entry != configured_test_suites_.end()) {
+      write_skip_configuration(suite_entry->second);
+    }
+    auto suite_tunables_entry = configured_suite_tunables_.find(suite_name);
+    if (suite_tunables_entry != configured_suite_tunables_.end()) {
+      write_tunables(suite_tunables_entry->second);
+    }
+    auto filter_entry = configured_suite_filters_.find(suite_name);
+    if (filter_entry != configured_suite_filters_.end()) {
+      write_filter(filter_entry->second);
+    }
+    auto sweeps_entry = configured_sweeps_.find(suite_name);
+    if (sweeps_entry != configured_sweeps_.end()) {
+      writer.BeginObject("sweeps");
+      for (auto& sweep : sweeps_entry->second) {
+        writer.AddArray(sweep.first.c_str(), sweep.second);
+      }
+      writer.EndObject();
+    }
+
+    std::set<std::string> test_names;
+    auto cases_entry = configured_test_cases_.find(suite_name);
+    if (cases_entry != configured_test_cases_.end()) {
+      for (auto& test_case : cases_entry->second) {
+        test_names.insert(test_case.first);
+      }
+    }
+    auto test_tunables_entry = configured_test_tunables_.find(suite_name);
+    if (test_tunables_entry != configured_test_tunables_.end()) {
+      for (auto& test_case : test_tunables_entry->second) {
+        test_names.insert(test_case.first);
+      }
+    }
+    for (auto& test_name : test_names) {
+      writer.BeginObject(test_name.c_str());
+      if (cases_entry != configured_test_cases_.end()) {
+        auto test_case = cases_entry->second.find(test_name);
+        if (test_case != cases_entry->second.end()) {
+          write_skip_configuration(test_case->second);
+        }
+      }
+      if (test_tunables_entry != configured_test_tunables_.end()) {
+        auto test_case = test_tunables_entry->second.find(test_name);
+        if (test_case != test_tunables_entry->second.end()) {
+          write_tunables(test_case->second);
+        }
+      }
+      writer.EndObject();
+    }
+    writer.EndObject();
+  }
+  writer.EndObject();
+}
+
 std::string RuntimeConfig::SanitizePath(const std::string& path) {
   std::string sanitized(path);
   std::replace(sanitized.begin(), sanitized.end(), '/', '\\');
@@ -5,8 +5,14 @@
 #include <vector>
 
 #include "configure.h"
+#include "json_writer.h"
+#include "result_stream.h"
+#include "test_order.h"
+#include "test_pattern.h"
 #include "tests/test_suite.h"
 
+struct json_s;
+
 class RuntimeConfig {
  public:
   enum class SkipConfiguration {
@@ -15,6 +21,14 @@ class RuntimeConfig {
     UNSKIPPED,
   };
 
+  //! Patterns that select tests by name.
+  struct TestFilter {
+    //! If not empty, only tests matching at least one pattern are enabled.
+    std::vector<TestPattern> include;
+    //! Tests matching any of these patterns are disabled.
+    std::vector<TestPattern> exclude;
+  };
+
  public:
   RuntimeConfig() = default;
   explicit RuntimeConfig(const RuntimeConfig&) = delete;
@@ -35,28 +49,74 @@ class RuntimeConfig {
    */
   bool LoadConfigBuffer(const std::string& config_content, std::vector<std::string>& errors);
 
+  /**
+   * Applies the compile-time default profile (if any) to the default settings, for use when no config file could be
+   * loaded.
+   * @param errors - Vector of strings into which any error messages will be placed.
+   * @return true on success, false on failure
+   */
+  bool LoadDefaultConfig(std::vector<std::string>& errors);
+
   /**
    * Processes the JSON config file at the given path and adjusts the given set of test suites. Returns false if parsing
    * fails for any reason.
    */
   bool ApplyConfig(std::vector<std::shared_ptr<TestSuite>>& test_suites, std::vector<std::string>& errors);
 
+  //! Writes the resolved "settings" and "test_suites" configuration to the given (open) JSON object.
+  void WriteSettings(JsonWriter& writer) const;
+
   [[nodiscard]] bool disable_autorun() const { return disable_autorun_; }
   [[nodiscard]] bool enable_autorun_immediately() const { return enable_autorun_immediately_; }
   [[nodiscard]] bool enable_shutdown_on_completion() const { return enable_shutdown_on_completion_; }
   [[nodiscard]] bool skip_tests_by_default() const { return skip_tests_by_default_; }
   [[nodiscard]] uint32_t reboot_or_shutdown_delay_ms() const { return reboot_or_shutdown_delay_ms_; }
+  [[nodiscard]] bool buffer_results_in_memory() const { return buffer_results_in_memory_; }
+  [[nodiscard]] bool binary_raw_samples() const { return binary_raw_samples_; }
+  [[nodiscard]] ResultStream::Transport stream_results() const { return stream_results_; }
+  [[nodiscard]] TestHost::TimingMode timing_mode() const { return timing_mode_; }
+  [[nodiscard]] TestHost::TimerSource timer_source() const { return timer_source_; }
+  [[nodiscard]] const TestSuite::Config& suite_config() const { return suite_config_; }
+  [[nodiscard]] uint32_t repeat_passes() const { return repeat_passes_; }
+  [[nodiscard]] TestOrder test_order() const { return test_order_; }
+  [[nodiscard]] uint32_t random_seed() const { return random_seed_; }
+  [[nodiscard]] bool write_checkpoints() const { return write_checkpoints_; }
+  [[nodiscard]] bool resume_from_checkpoints() const { return resume_from_checkpoints_; }
+  [[nodiscard]] bool capture_framebuffers() const { return capture_framebuffers_; }
+  [[nodiscard]] bool trace_events() const { return trace_events_; }
+  [[nodiscard]] bool dry_run() const { return dry_run_; }
+  //! Name of the profile applied on top of the base settings, empty if none was selected.
+  [[nodiscard]] const std::string& profile() const { return profile_; }
 
   [[nodiscard]] const std::string& output_directory_path() const { return output_directory_path_; }
 
   static std::string SanitizePath(const std::string& path);
 
+ private:
+  //! Loads the values present in the given "settings" object, leaving any that are absent unchanged.
+  bool LoadSettings(json_s const* settings, std::vector<std::string>& errors);
+
  private:
   bool disable_autorun_ = DEFAULT_DISABLE_AUTORUN;
   bool enable_autorun_immediately_ = DEFAULT_AUTORUN_IMMEDIATELY;
   bool enable_shutdown_on_completion_ = DEFAULT_ENABLE_SHUTDOWN;
   bool skip_tests_by_default_ = DEFAULT_SKIP_TESTS_BY_DEFAULT;
   uint32_t reboot_or_shutdown_delay_ms_ = 10000;
+  bool buffer_results_in_memory_ = false;
+  bool binary_raw_samples_ = false;
+  ResultStream::Transport stream_results_ = ResultStream::Transport::NONE;
+  TestHost::TimingMode timing_mode_ = TestHost::TimingMode::SUBMIT;
+  TestHost::TimerSource timer_source_ = TestHost::TimerSource::PERFORMANCE_COUNTER;
+  TestSuite::Config suite_config_{};
+  uint32_t repeat_passes_ = 1;
+  TestOrder test_order_ = TestOrder::SORTED;
+  uint32_t random_seed_ = 0;
+  bool write_checkpoints_ = false;
+  bool resume_from_checkpoints_ = false;
+  bool capture_framebuffers_ = false;
+  bool trace_events_ = false;
+  bool dry_run_ = false;
+  std::string profile_ = DEFAULT_RUNTIME_PROFILE;
 
   std::string output_directory_path_ = SanitizePath(DEFAULT_OUTPUT_DIRECTORY_PATH);
 
@@ -64,6 +124,16 @@ class RuntimeConfig {
   std::map<std::string, SkipConfiguration> configured_test_suites_;
   //! Map of test suite name to a map of test case to skip config.
   std::map<std::string, std::map<std::string, SkipConfiguration>> configured_test_cases_;
+  //! Map of test suite name to tunable overrides applied to every test in the suite.
+  std::map<std::string, TestSuite::TunableValues> configured_suite_tunables_;
+  //! Map of test suite name to a map of test case to tunable overrides.
+  std::map<std::string, std::map<std::string, TestSuite::TunableValues>> configured_test_tunables_;
+  //! Map of test suite name to a map of parameter name to the values over which it is swept.
+  std::map<std::string, std::map<std::string, std::vector<uint32_t>>> configured_sweeps_;
+  //! Patterns matched against the full name ("<suite>::<test>") of every test.
+  TestFilter test_filter_;
+  //! Map of test suite name to patterns matched against the names of the tests in that suite.
+  std::map<std::string, TestFilter> configured_suite_filters_;
 };
 
 #endif  // XEMU_PERF_TESTS_RUNTIME_CONFIG_H
@@ -0,0 +1,97 @@
+#include "statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Scales the MAD such that it is a consistent estimator of the standard deviation for normally distributed data.
+static constexpr double kMADToStddev = 1.4826;
+// Scales the mean absolute deviation to a consistent estimator of the standard deviation for normal data.
+static constexpr double kMeanAbsoluteDeviationToStddev = 1.2533;
+// Two sided z score for a 95% confidence interval.
+static constexpr double kZ95 = 1.96;
+
+double SampleStatistics::Percentile(const std::vector<double> &sorted_samples, double percentile) {
+  if (sorted_samples.empty()) {
+    return 0.0;
+  }
+
+  const double rank = (percentile / 100.0) * static_cast<double>(sorted_samples.size() - 1);
+  const auto lower = static_cast<size_t>(std::floor(rank));
+  const auto upper = std::min(lower + 1, sorted_samples.size() - 1);
+  const double fraction = rank - static_cast<double>(lower);
+  return sorted_samples[lower] + (sorted_samples[upper] - sorted_samples[lower]) * fraction;
+}
+
+SampleStatistics SampleStatistics::Compute(const std::vector<uint64_t> &samples) {
+  SampleStatistics ret;
+  if (samples.empty()) {
+    return ret;
+  }
+
+  std::vector<double> sorted(samples.begin(), samples.end());
+  std::sort(sorted.begin(), sorted.end());
+  const auto count = static_cast<double>(sorted.size());
+
+  double sum = 0.0;
+  for (auto val : sorted) {
+    sum += val;
+  }
+  ret.mean = sum / count;
+
+  double sum_of_squares = 0.0;
+  for (auto val : sorted) {
+    sum_of_squares += (val - ret.mean) * (val - ret.mean);
+  }
+  ret.stddev = sorted.size() > 1 ? std::sqrt(sum_of_squares / (count - 1.0)) : 0.0;
+
+  ret.median = Percentile(sorted, 50.0);
+  ret.p90 = Percentile(sorted, 90.0);
+  ret.p99 = Percentile(sorted, 99.0);
+
+  std::vector<double> deviations;
+  deviations.reserve(sorted.size());
+  double sum_of_deviations = 0.0;
+  for (auto val : sorted) {
+    auto deviation = std::fabs(val - ret.median);
+    deviations.push_back(deviation);
+    sum_of_deviations += deviation;
+  }
+  std::sort(deviations.begin(), deviations.end());
+  ret.mad = Percentile(deviations, 50.0);
+
+  // Timings are frequently quantized such that more than half of the samples are identical, fall back to the mean
+  // absolute deviation in that case so that a single large hitch can still be identified.
+  double scale = ret.mad * kMADToStddev;
+  if (scale == 0.0) {
+    scale = (sum_of_deviations / count) * kMeanAbsoluteDeviationToStddev;
+  }
+
+  double robust_sum = 0.0;
+  uint32_t robust_count = 0;
+  for (auto val : sorted) {
+    if (scale > 0.0 && std::fabs(val - ret.median) > kOutlierThreshold * scale) {
+      ++ret.outliers_rejected;
+      continue;
+    }
+    robust_sum += val;
+    ++robust_count;
+  }
+  ret.robust_mean = robust_count ? robust_sum / robust_count : ret.median;
+
+  // The ranks of the order statistics bounding the median follow Binomial(n, 0.5), use the normal approximation.
+  const double rank_offset = kZ95 * std::sqrt(count) / 2.0;
+  const auto lower_rank = static_cast<int32_t>(std::floor(count / 2.0 - rank_offset));
+  const auto upper_rank = static_cast<int32_t>(std::ceil(count / 2.0 + rank_offset));
+  const auto last_index = static_cast<int32_t>(sorted.size()) - 1;
+  ret.median_ci95_low = sorted[std::clamp(lower_rank - 1, 0, last_index)];
+  ret.median_ci95_high = sorted[std::clamp(upper_rank - 1, 0, last_index)];
+
+  return ret;
+}
+
+double SampleStatistics::MedianPrecisionPercent() const {
+  if (median <= 0.0) {
+    return 0.0;
+  }
+  return ((median_ci95_high - median_ci95_low) * 0.5 / median) * 100.0;
+}
@@ -0,0 +1,38 @@
+#ifndef XEMU_PERF_TESTS_STATISTICS_H
+#define XEMU_PERF_TESTS_STATISTICS_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Robust summary statistics for a set of timing samples.
+ */
+struct SampleStatistics {
+  //! Samples whose distance from the median exceeds this many (normal-consistent) MADs are treated as outliers.
+  static constexpr double kOutlierThreshold = 3.5;
+
+  double mean{0.0};
+  double median{0.0};
+  double p90{0.0};
+  double p99{0.0};
+  double stddev{0.0};
+  //! Median absolute deviation from the median (unscaled).
+  double mad{0.0};
+  //! Mean of the samples that remain after outlier rejection.
+  double robust_mean{0.0};
+  uint32_t outliers_rejected{0};
+  //! Distribution-free 95% confidence interval of the median, based on order statistics.
+  double median_ci95_low{0.0};
+  double median_ci95_high{0.0};
+
+  //! Returns the half width of the 95% confidence interval of the median as a percentage of the median.
+  [[nodiscard]] double MedianPrecisionPercent() const;
+
+  //! Computes statistics for the given samples. Results are in the same units as the samples.
+  static SampleStatistics Compute(const std::vector<uint64_t> &samples);
+
+  //! Returns the linearly interpolated percentile (0 - 100) of the given sorted samples.
+  static double Percentile(const std::vector<double> &sorted_samples, double percentile);
+};
+
+#endif  // XEMU_PERF_TESTS_STATISTICS_H
@@ -12,7 +12,16 @@
 #include <windows.h>
 #pragma clang diagnostic pop
 
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "debug_output.h"
+#include "json_writer.h"
+#include "logger.h"
 #include "menu_item.h"
+#include "trace_recorder.h"
 
 static constexpr auto kButtonRepeatMilliseconds = 150;
 
@@ -101,11 +110,274 @@ void TestDriver::Run() {
   }
 }
 
+void TestDriver::SetRunPlan(uint32_t passes, TestOrder order, uint32_t seed) {
+  passes_ = std::max(passes, 1U);
+  test_order_ = order;
+  seed_ = seed ? seed : static_cast<uint32_t>(test_host_.ReadTimer());
+}
+
+const char *TestDriver::TestOrderName(TestOrder order) {
+  switch (order) {
+    case TestOrder::SORTED:
+      return "sorted";
+    case TestOrder::RANDOM:
+      return "random";
+    case TestOrder::INTERLEAVED:
+      return "interleaved";
+  }
+  return "unknown";
+}
+
+std::vector<TestDriver::RunStep> TestDriver::BuildRunPlan() const {
+  std::vector<RunStep> ret;
+  std::mt19937 random_engine(seed_);
+
+  for (uint32_t pass = 0; pass < passes_; ++pass) {
+    const auto pass_start = ret.size();
+
+    if (test_order_ == TestOrder::INTERLEAVED) {
+      std::vector<std::pair<std::shared_ptr<TestSuite>, std::vector<std::string>>> remaining;
+      for (auto &suite : test_suites_) {
+        if (suite->HasEnabledTests()) {
+          remaining.emplace_back(suite, suite->TestNames());
+        }
+      }
+      if (!remaining.empty()) {
+        std::rotate(remaining.begin(), remaining.begin() + (pass % remaining.size()), remaining.end());
+      }
+
+      bool added = true;
+      for (uint32_t index = 0; added; ++index) {
+        added = false;
+        for (auto &entry : remaining) {
+          if (index < entry.second.size()) {
+            ret.push_back({entry.first, entry.second[index], pass});
+            added = true;
+          }
+        }
+      }
+      continue;
+    }
+
+    for (auto &suite : test_suites_) {
+      for (auto &test_name : suite->TestNames()) {
+        ret.push_back({suite, test_name, pass});
+      }
+    }
+
+    if (test_order_ == TestOrder::RANDOM) {
+      std::shuffle(ret.begin() + static_cast<ptrdiff_t>(pass_start), ret.end(), random_engine);
+    }
+  }
+
+  return ret;
+}
+
+uint32_t TestDriver::WriteRunPlan(const std::string &plan_path) const {
+  auto run_plan = BuildRunPlan();
+
+  std::ofstream plan_file(plan_path, std::ios_base::trunc);
+  ASSERT(plan_file && "Failed to open test plan file for output");
+
+  plan_file << "# " << run_plan.size() << " tests, " << passes_ << " passes in " << TestOrderName(test_order_)
+            << " order (seed " << seed_ << ")\n";
+  uint32_t pass = 0;
+  for (auto &step : run_plan) {
+    if (passes_ > 1 && (&step == &run_plan.front() || step.pass != pass)) {
+      pass = step.pass;
+      plan_file << "# Pass " << pass << "\n";
+    }
+    plan_file << step.suite->Name() << "::" << step.test_name << "\n";
+  }
+  plan_file.close();
+  ASSERT(plan_file && "Failed to write test plan file");
+
+  return static_cast<uint32_t>(run_plan.size());
+}
+
+//! Reads the results record from the given checkpoint, along with the raw samples sidecar record that accompanies it
+//! if the results record refers to the sidecar. Returns false if there is no valid checkpoint.
+static bool ReadCheckpoint(const std::string &checkpoint_path, std::string &record, std::string &raw_samples) {
+  std::ifstream checkpoint(checkpoint_path);
+  if (!checkpoint) {
+    return false;
+  }
+
+  std::getline(checkpoint, record);
+  if (record.empty() || record.front() != '{' || record.back() != '}') {
+    PrintMsg("Ignoring invalid checkpoint %s\n", checkpoint_path.c_str());
+    return false;
+  }
+  // Checkpoints of individual passes are only meaningful to a run that merges passes.
+  if (record.find(R"("passes":[)") != std::string::npos) {
+    PrintMsg("Ignoring multi-pass checkpoint %s\n", checkpoint_path.c_str());
+    return false;
+  }
+
+  raw_samples.clear();
+  if (record.find(R"("raw_ticks_in_sidecar":true)") == std::string::npos) {
+    return true;
+  }
+
+  // The samples can only be restored into the sidecar of this run.
+  if (!Logger::HasRawSamples()) {
+    PrintMsg("Ignoring checkpoint %s, which requires binary_raw_samples\n", checkpoint_path.c_str());
+    return false;
+  }
+  std::ifstream samples(TestHost::CheckpointRawSamplesPath(checkpoint_path), std::ios_base::binary);
+  raw_samples.assign(std::istreambuf_iterator<char>(samples), std::istreambuf_iterator<char>());
+  if (raw_samples.empty()) {
+    PrintMsg("Ignoring checkpoint %s without raw samples\n", checkpoint_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+//! Reads the record of each pass from the given checkpoint of a multi-pass run. Returns false if there is no valid
+//! checkpoint.
+static bool ReadPassCheckpoints(const std::string &checkpoint_path, std::vector<std::string> &records) {
+  std::ifstream checkpoint(checkpoint_path);
+  if (!checkpoint) {
+    return false;
+  }
+
+  records.clear();
+  std::string record;
+  while (std::getline(checkpoint, record)) {
+    if (record.empty() || record.front() != '{' || record.back() != '}') {
+      PrintMsg("Ignoring invalid checkpoint %s\n", checkpoint_path.c_str());
+      return false;
+    }
+    records.push_back(record);
+  }
+
+  return !records.empty();
+}
+
+bool TestDriver::RestorePassCheckpoints(const std::string &full_name, const std::string &checkpoint_path,
+                                        std::set<std::pair<std::string, uint32_t>> &restored_steps) {
+  std::vector<std::string> records;
+  if (!ReadPassCheckpoints(checkpoint_path, records)) {
+    return false;
+  }
+
+  // Every pass is validated before any is restored, so that a damaged checkpoint is discarded as a whole.
+  std::vector<std::pair<uint32_t, TestHost::ProfileResults>> passes;
+  std::set<uint32_t> seen_passes;
+  for (const auto &record : records) {
+    std::string name;
+    TestHost::ProfileResults results;
+    if (!test_host_.ParseResultRecord(record, name, results) || name != full_name || results.passes.size() != 1 ||
+        results.passes.front().pass >= passes_ || !seen_passes.insert(results.passes.front().pass).second) {
+      PrintMsg("Ignoring invalid checkpoint %s\n", checkpoint_path.c_str());
+      return false;
+    }
+    passes.emplace_back(results.passes.front().pass, std::move(results));
+  }
+
+  for (uint32_t i = 0; i < passes.size(); ++i) {
+    test_host_.MergeDeferredPass(full_name, passes[i].second, records[i]);
+    restored_steps.emplace(full_name, passes[i].first);
+  }
+  return true;
+}
+
 void TestDriver::RunAllTestsNonInteractive() {
-  for (auto &suite : test_suites_) {
-    suite->Initialize();
-    suite->RunAll();
-    suite->Deinitialize();
+  const bool merge_passes = passes_ > 1;
+  if (merge_passes || test_order_ != TestOrder::SORTED) {
+    PrintMsg("Running %u passes in %s order (seed %u)\n", passes_, TestOrderName(test_order_), seed_);
+  }
+
+  auto run_plan = BuildRunPlan();
+
+  // Checkpoints from a previous run are either reused or discarded, so that resuming a later run can never pick up
+  // results that predate it. When merging passes, each completed pass is restored into the deferred results and only
+  // the remaining passes are run.
+  test_host_.SetDeferResults(merge_passes);
+  std::set<std::string> checkpointed_tests;
+  // (full test name, pass) of each step restored from a checkpoint.
+  std::set<std::pair<std::string, uint32_t>> restored_steps;
+  // (results record, raw samples sidecar record) of each test restored from a checkpoint of a single pass run.
+  std::vector<std::pair<std::string, std::string>> checkpointed_records;
+  for (auto &step : run_plan) {
+    auto full_name = step.suite->Name() + "::" + step.test_name;
+    if (step.pass || checkpointed_tests.count(full_name)) {
+      continue;
+    }
+
+    auto checkpoint_path = step.suite->CheckpointPath(step.test_name);
+    std::string record;
+    std::string raw_samples;
+    bool restored = false;
+    if (resume_from_checkpoints_ && merge_passes) {
+      restored = RestorePassCheckpoints(full_name, checkpoint_path, restored_steps);
+    } else if (resume_from_checkpoints_ && ReadCheckpoint(checkpoint_path, record, raw_samples)) {
+      restored = true;
+      restored_steps.emplace(full_name, 0);
+      checkpointed_records.emplace_back(record, raw_samples);
+    }
+
+    if (restored) {
+      checkpointed_tests.insert(full_name);
+    } else {
+      DeleteFile(checkpoint_path.c_str());
+      DeleteFile(TestHost::CheckpointRawSamplesPath(checkpoint_path).c_str());
+    }
+  }
+  if (resume_from_checkpoints_) {
+    PrintMsg("Resuming run, %u passes of %u tests restored from checkpoints\n",
+             static_cast<uint32_t>(restored_steps.size()), static_cast<uint32_t>(checkpointed_tests.size()));
+  }
+
+  JsonWriter plan;
+  plan.BeginObject();
+  plan.Add("type", "run_plan");
+  plan.Add("passes", passes_);
+  plan.Add("order", TestOrderName(test_order_));
+  plan.Add("seed", seed_);
+  plan.Add("resumed", resume_from_checkpoints_);
+  plan.Add("tests_restored_from_checkpoints", static_cast<uint32_t>(checkpointed_tests.size()));
+  plan.Add("passes_restored_from_checkpoints", static_cast<uint32_t>(restored_steps.size()));
+  plan.EndObject();
+  Logger::Log() << plan.str() << std::endl;
+  for (auto &record : checkpointed_records) {
+    Logger::Log() << record.first << std::endl;
+    if (!record.second.empty()) {
+      Logger::RawSamples().write(record.second.data(), static_cast<std::streamsize>(record.second.size()));
+    }
+  }
+
+  // Suites are initialized whenever execution moves to a different suite, so orders that alternate between suites pay
+  // the initialization cost repeatedly but never run a test against another suite's state.
+  std::shared_ptr<TestSuite> active_suite;
+  for (auto &step : run_plan) {
+    if (restored_steps.count({step.suite->Name() + "::" + step.test_name, step.pass})) {
+      continue;
+    }
+
+    if (step.suite != active_suite) {
+      if (active_suite) {
+        TraceRecorder::Scope trace_scope("suite", active_suite->Name() + "::Deinitialize");
+        active_suite->Deinitialize();
+      }
+      active_suite = step.suite;
+      TraceRecorder::Scope trace_scope("suite", active_suite->Name() + "::Initialize");
+      active_suite->Initialize();
+    }
+
+    test_host_.SetCurrentPass(step.pass);
+    active_suite->Run(step.test_name, true);
+  }
+  if (active_suite) {
+    TraceRecorder::Scope trace_scope("suite", active_suite->Name() + "::Deinitialize");
+    active_suite->Deinitialize();
+  }
+  TraceRecorder::Flush();
+
+  if (merge_passes) {
+    test_host_.FlushDeferredResults();
+    test_host_.SetDeferResults(false);
   }
   running_ = false;
 }
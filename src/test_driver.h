@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "test_host.h"
+#include "test_order.h"
 #include "tests/test_suite.h"
 
 constexpr uint32_t kMaxGamepads = 4;
@@ -33,7 +34,43 @@ class TestDriver {
   //! Runs all tests automatically without reacting to any user input.
   void RunAllTestsNonInteractive();
 
+  /**
+   * Configures how RunAllTestsNonInteractive executes the test list.
+   * @param passes - Number of times that every test is executed. Results from multiple passes are merged per test.
+   * @param order - The order in which tests are executed within each pass.
+   * @param seed - Seed used to shuffle tests in RANDOM order. 0 selects a seed based on the current time.
+   */
+  void SetRunPlan(uint32_t passes, TestOrder order, uint32_t seed);
+
+  static const char *TestOrderName(TestOrder order);
+
+  /**
+   * Writes the list of tests that RunAllTestsNonInteractive would execute, in order, without running them.
+   * @param plan_path - The path of the text file to write.
+   * @return The number of tests in the plan.
+   */
+  uint32_t WriteRunPlan(const std::string &plan_path) const;
+
+  //! When enabled, RunAllTestsNonInteractive skips tests that have a checkpoint from a previous run, copying the
+  //! checkpointed results into the log instead. When running multiple passes, only the checkpointed passes are skipped
+  //! and they are merged with the remaining ones. Otherwise any existing checkpoints are discarded.
+  void SetResumeFromCheckpoints(bool enable = true) { resume_from_checkpoints_ = enable; }
+
  private:
+  struct RunStep {
+    std::shared_ptr<TestSuite> suite;
+    std::string test_name;
+    uint32_t pass;
+  };
+
+  //! Returns the ordered list of tests to be executed by RunAllTestsNonInteractive.
+  [[nodiscard]] std::vector<RunStep> BuildRunPlan() const;
+  //! Restores each pass recorded in the given checkpoint of a multi-pass run into the deferred results of the test
+  //! host, adding (full_name, pass) to `restored_steps` for each. Returns false, restoring nothing, if the checkpoint is
+  //! missing or any of its passes is invalid.
+  bool RestorePassCheckpoints(const std::string &full_name, const std::string &checkpoint_path,
+                              std::set<std::pair<std::string, uint32_t>> &restored_steps);
+
   void OnControllerAdded(const SDL_ControllerDeviceEvent &event);
   void OnControllerRemoved(const SDL_ControllerDeviceEvent &event);
   void OnControllerButtonEvent(const SDL_ControllerButtonEvent &event);
@@ -59,6 +96,10 @@ class TestDriver {
 
   TestHost &test_host_;
   const std::vector<std::shared_ptr<TestSuite>> &test_suites_;
+  uint32_t passes_{1};
+  TestOrder test_order_{TestOrder::SORTED};
+  uint32_t seed_{0};
+  bool resume_from_checkpoints_{false};
   SDL_GameController *gamepads_[kMaxGamepads]{nullptr};
 
   std::shared_ptr<MenuItem> active_menu_;
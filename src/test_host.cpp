@@ -1,8 +1,13 @@
 #include "test_host.h"
 
 #include <SDL.h>
+#include <SDL_image.h>
 #include <strings.h>
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wmacro-redefined"
 #include <windows.h>
@@ -12,24 +17,44 @@
 #include <xboxkrnl/xboxkrnl.h>
 
 #include "debug_output.h"
+#include "json_parser.h"
+#include "json_writer.h"
 #include "logger.h"
+#include "pushbuffer.h"
+#include "raw_sample_encoding.h"
 #include "shaders/vertex_shader_program.h"
+#include "statistics.h"
 #include "xbox_math_matrix.h"
 #include "xbox_math_types.h"
 
 using namespace XboxMath;
 
 static constexpr uint32_t kResultsOverlayColor = 0x88000000;
+// Physical addresses targeted by pushbuffer jumps are accessible through the contiguous memory mapping at this base.
+static constexpr uint32_t kContiguousMemoryBase = 0x80000000;
+// Address of the DMA put register of the pushbuffer channel, holding the physical address up to which pbkit has
+// submitted commands to the GPU.
+static constexpr uint32_t kUserDmaPutRegister = 0xFD800040;
+// Upper bound on the number of words walked for a single accounted span, guarding against misparsed commands.
+static constexpr uint32_t kMaxAccountedSpanWords = 0x1000000;
+
+// Duration over which the timestamp counter is compared against the performance counter when calibrating.
+static constexpr uint32_t kTimestampCalibrationMilliseconds = 100;
 
 #define MAX_FILE_PATH_SIZE 248
 #define MAX_FILENAME_SIZE 42
 
+static constexpr char kCheckpointTempExtension[] = ".tmp";
+// Same length as the checkpoint extension so that the name derived from a FATX compatible checkpoint name is valid.
+static constexpr char kCheckpointRawSamplesExtension[] = ".ckps";
+
 TestHost::TestHost(uint32_t framebuffer_width, uint32_t framebuffer_height, uint32_t max_texture_width,
                    uint32_t max_texture_height, uint32_t max_texture_depth)
     : NV2AState(framebuffer_width, framebuffer_height, max_texture_width, max_texture_height, max_texture_depth) {
   LARGE_INTEGER frequency;
   QueryPerformanceFrequency(&frequency);
   perf_counter_frequency_ = static_cast<double>(frequency.QuadPart);
+  timer_frequency_ = frequency.QuadPart;
   QueryPerformanceCounter(&last_frame_time_);
 }
 
@@ -59,6 +84,21 @@ void TestHost::EnsureFolderExists(const std::string &folder_path) {
 }
 
 void TestHost::FinishDraw(const std::string &suite_name, const std::string &test_name, const ProfileResults &results) {
+  TraceRecorder::Scope trace_scope("draw", "FinishDraw");
+
+  // The capture is taken before the results overlay is composited, so that it contains only the test's rendering.
+  std::string framebuffer_capture;
+  if (save_results_ && capture_framebuffers_ && !framebuffer_capture_path_.empty()) {
+    WaitForGPUIdle();
+    if (SaveBackBuffer(framebuffer_capture_path_)) {
+      // Recorded relative to the output directory as "<suite directory>/<file name>".
+      auto file_separator = framebuffer_capture_path_.rfind('\\');
+      auto suite_separator = framebuffer_capture_path_.rfind('\\', file_separator - 1);
+      framebuffer_capture = framebuffer_capture_path_.substr(suite_separator + 1);
+      framebuffer_capture[file_separator - suite_separator - 1] = '/';
+    }
+  }
+
   SetVertexShaderProgram(nullptr);
   SetXDKDefaultViewportAndFixedFunctionMatrices();
 
@@ -74,17 +114,45 @@ void TestHost::FinishDraw(const std::string &suite_name, const std::string &test
   SetScreenVertex(0.f, GetFramebufferHeightF());
   End();
 
-  auto micro_to_milliseconds = [](uint32_t microseconds) -> double {
-    return static_cast<double>(microseconds) / 1000.0;
-  };
+  auto nano_to_milliseconds = [](double nanoseconds) -> double { return nanoseconds / 1000000.0; };
+
+  const bool has_submit_times = results.timing_mode == TimingMode::GPU_COMPLETION;
 
   pb_print("%s::%s\n", suite_name.c_str(), test_name.c_str());
   if (save_results_) {
-    pb_print("  %lu iterations\n", results.iterations);
-    pb_print_with_floats("  Total: %f ms\n", micro_to_milliseconds(results.total_time_microseconds));
-    pb_print_with_floats("  Avg: %f ms\n", micro_to_milliseconds(results.average_time_microseconds));
-    pb_print_with_floats("  Min: %f ms\n", micro_to_milliseconds(results.minimum_time_microseconds));
-    pb_print_with_floats("  Max: %f ms\n", micro_to_milliseconds(results.maximum_time_microseconds));
+    pb_print("  %lu iterations (%s)\n", results.iterations, TimingModeName(results.timing_mode));
+    pb_print_with_floats("  Total: %f ms\n", nano_to_milliseconds(results.total_time_nanoseconds));
+    pb_print_with_floats("  Avg: %f ms\n", nano_to_milliseconds(results.average_time_nanoseconds));
+    pb_print_with_floats("  Min: %f ms\n", nano_to_milliseconds(results.minimum_time_nanoseconds));
+    pb_print_with_floats("  Max: %f ms\n", nano_to_milliseconds(results.maximum_time_nanoseconds));
+    pb_print_with_floats("  Median: %f ms +/- %f%%\n", nano_to_milliseconds(results.median_time_nanoseconds),
+                         results.precision_percent);
+    pb_print_with_floats("  P90: %f ms  P99: %f ms\n", nano_to_milliseconds(results.p90_time_nanoseconds),
+                         nano_to_milliseconds(results.p99_time_nanoseconds));
+    pb_print_with_floats("  Stddev: %f ms  MAD: %f ms\n", nano_to_milliseconds(results.stddev_nanoseconds),
+                         nano_to_milliseconds(results.mad_nanoseconds));
+    pb_print_with_floats("  Robust avg: %f ms (%lu outliers)\n",
+                         nano_to_milliseconds(results.robust_average_time_nanoseconds), results.outliers_rejected);
+    if (results.warmup_iterations) {
+      pb_print_with_floats("  Cold start: %f ms (%lu warmup%s)\n",
+                           nano_to_milliseconds(results.cold_start_time_nanoseconds), results.warmup_iterations,
+                           results.steady_state_reached ? ", steady" : "");
+    }
+    pb_print_with_floats("  Harness: %f ms%s\n", nano_to_milliseconds(results.harness_overhead_nanoseconds),
+                         results.harness_overhead_subtracted ? " (subtracted)" : "");
+    pb_print_with_floats("  Quiescence: %f ms\n", nano_to_milliseconds(results.quiescence_time_nanoseconds));
+    for (const auto &rate : GetThroughputRates(results)) {
+      pb_print_with_floats("  %s: %f M/s\n", rate.first, rate.second / 1000000.0);
+    }
+    const auto &traffic = results.pushbuffer_traffic;
+    pb_print_with_floats("  PB: %llu B, %llu methods, %llu Begin/End%s\n", traffic.bytes, traffic.methods,
+                         traffic.begin_end_pairs, traffic.complete ? "" : " (incomplete)");
+    if (traffic.methods) {
+      pb_print_with_floats("  %f us/method\n", results.median_time_nanoseconds / 1000.0 / traffic.methods);
+    }
+    if (has_submit_times) {
+      pb_print_with_floats("  Submit avg: %f ms\n", nano_to_milliseconds(results.average_submit_time_nanoseconds));
+    }
   } else {
     pb_print("Continuous mode: saving disabled\n");
     pb_print_with_floats("Average FPS: %f\n", average_frame_rate_);
@@ -96,23 +164,13 @@ void TestHost::FinishDraw(const std::string &suite_name, const std::string &test
   NV2AState::FinishDraw();
 
   if (save_results_) {
-    Logger::Log() << "  {" << std::endl;
-    Logger::Log() << R"(    "name": ")" << suite_name << "::" << test_name << "\"," << std::endl;
-    Logger::Log() << "    \"iterations\": " << results.iterations << "," << std::endl;
-    Logger::Log() << "    \"total_us\": " << results.total_time_microseconds << "," << std::endl;
-    Logger::Log() << "    \"average_us\": " << results.average_time_microseconds << "," << std::endl;
-    Logger::Log() << "    \"min_us\": " << results.minimum_time_microseconds << "," << std::endl;
-    Logger::Log() << "    \"max_us\": " << results.maximum_time_microseconds << "," << std::endl;
-    Logger::Log() << "    \"raw_results\": [";
-    std::string separator;
-    for (auto val : results.raw_results) {
-      Logger::Log() << separator << std::endl;
-      separator = ",";
-      Logger::Log() << "      " << val;
-    }
-    Logger::Log() << std::endl;
-    Logger::Log() << "    ]" << std::endl;
-    Logger::Log() << "  }," << std::endl;
+    if (framebuffer_capture.empty()) {
+      RecordResults(suite_name + "::" + test_name, results);
+    } else {
+      auto captured_results = results;
+      captured_results.framebuffer_capture = framebuffer_capture;
+      RecordResults(suite_name + "::" + test_name, captured_results);
+    }
   } else {
     LARGE_INTEGER now;
     QueryPerformanceCounter(&now);
@@ -136,6 +194,649 @@ void TestHost::FinishDraw(const std::string &suite_name, const std::string &test
   }
 }
 
+bool TestHost::SaveBackBuffer(const std::string &path) {
+  // Read through the AGP mapping so that the CPU sees what the GPU wrote rather than stale cache lines.
+  auto buffer = pb_agp_access(pb_back_buffer());
+  auto width = static_cast<int>(pb_back_buffer_width());
+  auto height = static_cast<int>(pb_back_buffer_height());
+  auto pitch = static_cast<int>(pb_back_buffer_pitch());
+
+  // The framebuffer is X8R8G8B8, the alpha channel is not meaningful.
+  auto surface = SDL_CreateRGBSurfaceWithFormatFrom(buffer, width, height, 32, pitch, SDL_PIXELFORMAT_RGB888);
+  if (!surface) {
+    PrintMsg("Failed to create surface for framebuffer capture: %s\n", SDL_GetError());
+    return false;
+  }
+
+  bool ret = IMG_SavePNG(surface, path.c_str()) == 0;
+  if (!ret) {
+    PrintMsg("Failed to save framebuffer capture %s: %s\n", path.c_str(), SDL_GetError());
+  }
+  SDL_FreeSurface(surface);
+  return ret;
+}
+
+std::string TestHost::MakeArtifactFileName(const std::string &test_name, const char *extension) {
+  const auto max_base_name_length = MAX_FILENAME_SIZE - strlen(extension);
+
+  std::string base_name = test_name;
+  for (auto &c : base_name) {
+    if (strchr("\\/:*?\"<>| ", c)) {
+      c = '_';
+    }
+  }
+
+  if (base_name.size() > max_base_name_length) {
+    uint32_t hash = 2166136261;
+    for (auto c : test_name) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 16777619;
+    }
+    char suffix[10];
+    snprintf(suffix, sizeof(suffix), "~%08x", hash);
+    base_name = base_name.substr(0, max_base_name_length - strlen(suffix)) + suffix;
+  }
+
+  return base_name + extension;
+}
+
+void TestHost::UpdateSummaryStatistics(ProfileResults &results) const {
+  const auto num_iterations = results.raw_results.size();
+  if (!num_iterations) {
+    return;
+  }
+
+  // Sums are accumulated in ticks and converted once to avoid compounding rounding errors.
+  uint64_t total_ticks = 0;
+  uint64_t minimum_ticks = UINT64_MAX;
+  uint64_t maximum_ticks = 0;
+  for (auto time : results.raw_results) {
+    total_ticks += time;
+    minimum_ticks = std::min(minimum_ticks, time);
+    maximum_ticks = std::max(maximum_ticks, time);
+  }
+  uint64_t total_submit_ticks = 0;
+  for (auto time : results.raw_submit_results) {
+    total_submit_ticks += time;
+  }
+
+  results.iterations = num_iterations;
+  results.total_time_nanoseconds = TicksToNanoseconds(total_ticks);
+  results.average_time_nanoseconds = TicksToNanoseconds(total_ticks / num_iterations);
+  results.minimum_time_nanoseconds = TicksToNanoseconds(minimum_ticks);
+  results.maximum_time_nanoseconds = TicksToNanoseconds(maximum_ticks);
+  results.total_submit_time_nanoseconds = TicksToNanoseconds(total_submit_ticks);
+  results.average_submit_time_nanoseconds = TicksToNanoseconds(total_submit_ticks / num_iterations);
+
+  const double ns_per_tick = GetNanosecondsPerTick();
+  auto stats = SampleStatistics::Compute(results.raw_results);
+  results.precision_percent = stats.MedianPrecisionPercent();
+  results.median_ci95_low_nanoseconds = stats.median_ci95_low * ns_per_tick;
+  results.median_ci95_high_nanoseconds = stats.median_ci95_high * ns_per_tick;
+  results.median_time_nanoseconds = stats.median * ns_per_tick;
+  results.p90_time_nanoseconds = stats.p90 * ns_per_tick;
+  results.p99_time_nanoseconds = stats.p99 * ns_per_tick;
+  results.stddev_nanoseconds = stats.stddev * ns_per_tick;
+  results.mad_nanoseconds = stats.mad * ns_per_tick;
+  results.robust_average_time_nanoseconds = stats.robust_mean * ns_per_tick;
+  results.outliers_rejected = stats.outliers_rejected;
+}
+
+std::vector<std::pair<const char *, double>> TestHost::GetThroughputRates(const ProfileResults &results) {
+  std::vector<std::pair<const char *, double>> ret;
+  if (results.median_time_nanoseconds <= 0.0) {
+    return ret;
+  }
+
+  const double iterations_per_second = 1000000000.0 / results.median_time_nanoseconds;
+  auto add = [&ret, iterations_per_second](const char *name, uint64_t units) {
+    if (units) {
+      ret.emplace_back(name, static_cast<double>(units) * iterations_per_second);
+    }
+  };
+  add("draws", results.work_per_iteration.draws);
+  add("vertices", results.work_per_iteration.vertices);
+  add("primitives", results.work_per_iteration.primitives);
+  add("pixels", results.work_per_iteration.pixels);
+  add("methods", results.work_per_iteration.methods);
+  return ret;
+}
+
+void TestHost::RecordResults(const std::string &name, const ProfileResults &results) {
+  if (!defer_results_) {
+    LogResults(name, results, checkpoint_path_);
+    return;
+  }
+
+  auto pass_results = results;
+  pass_results.passes = {{
+      .pass = current_pass_,
+      .iterations = results.iterations,
+      .median_time_nanoseconds = results.median_time_nanoseconds,
+      .robust_average_time_nanoseconds = results.robust_average_time_nanoseconds,
+      .cold_start_time_nanoseconds = results.cold_start_time_nanoseconds,
+      .quiescence_time_nanoseconds = results.quiescence_time_nanoseconds,
+  }};
+
+  // Each pass is checkpointed as soon as it completes, so that a crash part way through a multi-pass run only loses
+  // the pass in progress. Samples are always inline so that the pass can be merged again when resuming.
+  std::string pass_record;
+  if (!checkpoint_path_.empty()) {
+    pass_record = BuildResultRecord(name, pass_results, true);
+  }
+  MergeDeferredPass(name, pass_results, pass_record);
+
+  if (!checkpoint_path_.empty()) {
+    std::string checkpoint;
+    for (const auto &record : deferred_pass_records_[name]) {
+      checkpoint += checkpoint.empty() ? record : "\n" + record;
+    }
+    WriteCheckpoint(checkpoint_path_, checkpoint, "");
+  }
+}
+
+void TestHost::MergeDeferredPass(const std::string &name, const ProfileResults &results,
+                                   const std::string &pass_record) {
+  if (!pass_record.empty()) {
+    deferred_pass_records_[name].push_back(pass_record);
+  }
+
+  auto it = deferred_results_.find(name);
+  if (it == deferred_results_.end()) {
+    deferred_result_names_.push_back(name);
+    deferred_results_[name] = results;
+    return;
+  }
+
+  // The cold start, overhead calibration, and work declarations of the first pass are retained.
+  auto &merged = it->second;
+  merged.raw_results.insert(merged.raw_results.end(), results.raw_results.begin(), results.raw_results.end());
+  merged.raw_submit_results.insert(merged.raw_submit_results.end(), results.raw_submit_results.begin(),
+                                   results.raw_submit_results.end());
+  merged.warmup_iterations += results.warmup_iterations;
+  merged.steady_state_reached = merged.steady_state_reached && results.steady_state_reached;
+  merged.pushbuffer_traffic.complete = merged.pushbuffer_traffic.complete && results.pushbuffer_traffic.complete;
+  merged.passes.insert(merged.passes.end(), results.passes.begin(), results.passes.end());
+  UpdateSummaryStatistics(merged);
+}
+
+void TestHost::FlushDeferredResults() {
+  // The per-pass checkpoints are left in place, a resumed run merges them again rather than reading the merged result.
+  for (const auto &name : deferred_result_names_) {
+    LogResults(name, deferred_results_[name], "");
+  }
+  deferred_result_names_.clear();
+  deferred_results_.clear();
+  deferred_pass_records_.clear();
+}
+
+void TestHost::LogResults(const std::string &name, const ProfileResults &results,
+                          const std::string &checkpoint_path) const {
+  // Raw samples are either written to the binary sidecar or inline, never both.
+  const bool raw_samples_in_sidecar = Logger::HasRawSamples();
+  const auto *raw_submit_results =
+      results.timing_mode == TimingMode::GPU_COMPLETION ? &results.raw_submit_results : nullptr;
+  std::string raw_samples;
+  if (raw_samples_in_sidecar) {
+    if (checkpoint_path.empty()) {
+      WriteRawSampleRecord(Logger::RawSamples(), name, results.raw_results, raw_submit_results);
+    } else {
+      // The encoded record is kept so that the checkpoint can restore it into the sidecar of a resumed run.
+      std::ostringstream sample_record;
+      WriteRawSampleRecord(sample_record, name, results.raw_results, raw_submit_results);
+      raw_samples = sample_record.str();
+      Logger::RawSamples().write(raw_samples.data(), static_cast<std::streamsize>(raw_samples.size()));
+    }
+  }
+
+  const auto record = BuildResultRecord(name, results, !raw_samples_in_sidecar);
+  Logger::Log() << record << std::endl;
+
+  if (!checkpoint_path.empty()) {
+    WriteCheckpoint(checkpoint_path, record, raw_samples);
+  }
+}
+
+//! Writes the given content to a temporary file which then replaces the file at `path`, so that a crash can never leave
+//! a partially written file behind.
+static bool ReplaceFileAtomically(const std::string &path, const std::string &content) {
+  auto temp_path = path.substr(0, path.rfind('.')) + kCheckpointTempExtension;
+  {
+    std::ofstream temp_file(temp_path, std::ios_base::binary | std::ios_base::trunc);
+    temp_file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    temp_file.flush();
+    if (!temp_file) {
+      PrintMsg("Failed to write checkpoint %s\n", temp_path.c_str());
+      return false;
+    }
+  }
+
+  DeleteFile(path.c_str());
+  if (!MoveFile(temp_path.c_str(), path.c_str())) {
+    PrintMsg("Failed to commit checkpoint %s: %lu\n", path.c_str(), GetLastError());
+    return false;
+  }
+  return true;
+}
+
+void TestHost::WriteCheckpoint(const std::string &checkpoint_path, const std::string &record,
+                               const std::string &raw_samples) {
+  // The raw samples are committed first, so that a checkpoint that refers to the sidecar always has them.
+  if (!raw_samples.empty() && !ReplaceFileAtomically(CheckpointRawSamplesPath(checkpoint_path), raw_samples)) {
+    return;
+  }
+  ReplaceFileAtomically(checkpoint_path, record + "\n");
+}
+
+std::string TestHost::CheckpointRawSamplesPath(const std::string &checkpoint_path) {
+  return checkpoint_path.substr(0, checkpoint_path.rfind('.')) + kCheckpointRawSamplesExtension;
+}
+
+//! Reads the integer member with the given name into `value`, leaving it unchanged if it is absent.
+template <typename T>
+static bool ReadIntegerMember(json_t const *object, const char *name, T &value) {
+  auto member = json_getProperty(object, name);
+  if (!member) {
+    return true;
+  }
+  if (json_getType(member) != JSON_INTEGER || json_getInteger(member) < 0) {
+    return false;
+  }
+  value = static_cast<T>(json_getInteger(member));
+  return true;
+}
+
+//! Reads the numeric member with the given name into `value`, leaving it unchanged if it is absent.
+static bool ReadRealMember(json_t const *object, const char *name, double &value) {
+  auto member = json_getProperty(object, name);
+  if (!member) {
+    return true;
+  }
+  if (json_getType(member) == JSON_INTEGER) {
+    value = static_cast<double>(json_getInteger(member));
+    return true;
+  }
+  if (json_getType(member) != JSON_REAL) {
+    return false;
+  }
+  value = json_getReal(member);
+  return true;
+}
+
+//! Reads the boolean member with the given name into `value`, leaving it unchanged if it is absent.
+static bool ReadBooleanMember(json_t const *object, const char *name, bool &value) {
+  auto member = json_getProperty(object, name);
+  if (!member) {
+    return true;
+  }
+  if (json_getType(member) != JSON_BOOLEAN) {
+    return false;
+  }
+  value = json_getBoolean(member);
+  return true;
+}
+
+//! Reads the array of ticks with the given name into `values`.
+static bool ReadTicksMember(json_t const *object, const char *name, std::vector<uint64_t> &values) {
+  values.clear();
+  auto member = json_getProperty(object, name);
+  if (!member) {
+    return true;
+  }
+  if (json_getType(member) != JSON_ARRAY) {
+    return false;
+  }
+  for (auto element = json_getChild(member); element; element = json_getSibling(element)) {
+    if (json_getType(element) != JSON_INTEGER || json_getInteger(element) < 0) {
+      return false;
+    }
+    values.push_back(static_cast<uint64_t>(json_getInteger(element)));
+  }
+  return true;
+}
+
+bool TestHost::ParseResultRecord(const std::string &record, std::string &name, ProfileResults &results) const {
+  JSONParser parser(record.c_str());
+  auto root = parser.root();
+  if (!root || json_getType(root) != JSON_OBJ) {
+    return false;
+  }
+
+  auto name_member = json_getProperty(root, "name");
+  auto timing_mode_member = json_getProperty(root, "timing_mode");
+  if (!name_member || json_getType(name_member) != JSON_TEXT || !timing_mode_member ||
+      json_getType(timing_mode_member) != JSON_TEXT) {
+    return false;
+  }
+  name = json_getValue(name_member);
+
+  results = {};
+  const std::string timing_mode = json_getValue(timing_mode_member);
+  if (timing_mode == TimingModeName(TimingMode::SUBMIT)) {
+    results.timing_mode = TimingMode::SUBMIT;
+  } else if (timing_mode == TimingModeName(TimingMode::GPU_COMPLETION)) {
+    results.timing_mode = TimingMode::GPU_COMPLETION;
+  } else {
+    return false;
+  }
+
+  // Samples recorded with a different timer cannot be merged with those of this run.
+  if (!ReadIntegerMember(root, "timer_frequency", results.timer_frequency) ||
+      results.timer_frequency != timer_frequency_) {
+    return false;
+  }
+
+  double target_precision_percent = 0.0;
+  bool ok = ReadRealMember(root, "target_precision_percent", target_precision_percent) &&
+            ReadIntegerMember(root, "warmup_iterations", results.warmup_iterations) &&
+            ReadIntegerMember(root, "cold_start_ns", results.cold_start_time_nanoseconds) &&
+            ReadBooleanMember(root, "steady_state_reached", results.steady_state_reached) &&
+            ReadIntegerMember(root, "harness_overhead_ns", results.harness_overhead_nanoseconds) &&
+            ReadIntegerMember(root, "harness_submit_overhead_ns", results.harness_submit_overhead_nanoseconds) &&
+            ReadIntegerMember(root, "begin_end_overhead_ns", results.begin_end_overhead_nanoseconds) &&
+            ReadBooleanMember(root, "harness_overhead_subtracted", results.harness_overhead_subtracted) &&
+            ReadIntegerMember(root, "quiescence_ns", results.quiescence_time_nanoseconds) &&
+            ReadIntegerMember(root, "pushbuffer_bytes", results.pushbuffer_traffic.bytes) &&
+            ReadIntegerMember(root, "pushbuffer_method_headers", results.pushbuffer_traffic.method_headers) &&
+            ReadIntegerMember(root, "pushbuffer_methods", results.pushbuffer_traffic.methods) &&
+            ReadIntegerMember(root, "begin_end_pairs", results.pushbuffer_traffic.begin_end_pairs) &&
+            ReadBooleanMember(root, "pushbuffer_accounting_complete", results.pushbuffer_traffic.complete) &&
+            ReadTicksMember(root, "raw_ticks", results.raw_results) &&
+            ReadTicksMember(root, "raw_submit_ticks", results.raw_submit_results);
+  if (!ok || results.raw_results.empty()) {
+    return false;
+  }
+  results.target_precision_percent = static_cast<float>(target_precision_percent);
+
+  auto work = json_getProperty(root, "work_per_iteration");
+  if (work) {
+    auto &units = results.work_per_iteration;
+    if (json_getType(work) != JSON_OBJ || !ReadIntegerMember(work, "draws", units.draws) ||
+        !ReadIntegerMember(work, "vertices", units.vertices) ||
+        !ReadIntegerMember(work, "primitives", units.primitives) || !ReadIntegerMember(work, "pixels", units.pixels) ||
+        !ReadIntegerMember(work, "methods", units.methods)) {
+      return false;
+    }
+  }
+
+  auto passes = json_getProperty(root, "passes");
+  if (passes) {
+    if (json_getType(passes) != JSON_ARRAY) {
+      return false;
+    }
+    for (auto pass = json_getChild(passes); pass; pass = json_getSibling(pass)) {
+      PassSummary summary{};
+      if (json_getType(pass) != JSON_OBJ || !json_getProperty(pass, "pass") ||
+          !ReadIntegerMember(pass, "pass", summary.pass) || !ReadIntegerMember(pass, "iterations", summary.iterations) ||
+          !ReadRealMember(pass, "median_ns", summary.median_time_nanoseconds) ||
+          !ReadRealMember(pass, "robust_average_ns", summary.robust_average_time_nanoseconds) ||
+          !ReadIntegerMember(pass, "cold_start_ns", summary.cold_start_time_nanoseconds) ||
+          !ReadIntegerMember(pass, "quiescence_ns", summary.quiescence_time_nanoseconds)) {
+        return false;
+      }
+      results.passes.push_back(summary);
+    }
+  }
+
+  // Tunables and parameters are both objects mapping a name to an unsigned value.
+  auto read_named_values = [root](const char *member_name, std::vector<std::pair<std::string, uint32_t>> &values) {
+    auto member = json_getProperty(root, member_name);
+    if (!member) {
+      return true;
+    }
+    if (json_getType(member) != JSON_OBJ) {
+      return false;
+    }
+    for (auto element = json_getChild(member); element; element = json_getSibling(element)) {
+      if (json_getType(element) != JSON_INTEGER || json_getInteger(element) < 0) {
+        return false;
+      }
+      values.emplace_back(json_getName(element), static_cast<uint32_t>(json_getInteger(element)));
+    }
+    return true;
+  };
+  if (!read_named_values("tunables", results.tunables) || !read_named_values("parameters", results.parameters)) {
+    return false;
+  }
+
+  auto framebuffer_capture = json_getProperty(root, "framebuffer_capture");
+  if (framebuffer_capture && json_getType(framebuffer_capture) == JSON_TEXT) {
+    results.framebuffer_capture = json_getValue(framebuffer_capture);
+  }
+
+  UpdateSummaryStatistics(results);
+  return true;
+}
+
+std::string TestHost::BuildResultRecord(const std::string &name, const ProfileResults &results,
+                                        bool include_raw_samples) const {
+  const bool has_submit_times = results.timing_mode == TimingMode::GPU_COMPLETION;
+
+  JsonWriter record;
+  record.BeginObject();
+  record.Add("type", "test_result");
+  record.Add("name", name);
+  record.Add("timing_mode", TimingModeName(results.timing_mode));
+  record.Add("timer_source", TimerSourceName(timer_source_));
+  record.Add("timer_frequency", results.timer_frequency);
+  record.Add("iterations", results.iterations);
+  record.Add("total_ns", results.total_time_nanoseconds);
+  record.Add("average_ns", results.average_time_nanoseconds);
+  record.Add("min_ns", results.minimum_time_nanoseconds);
+  record.Add("max_ns", results.maximum_time_nanoseconds);
+  record.Add("median_ns", results.median_time_nanoseconds);
+  record.Add("median_ci95_low_ns", results.median_ci95_low_nanoseconds);
+  record.Add("median_ci95_high_ns", results.median_ci95_high_nanoseconds);
+  record.Add("precision_percent", results.precision_percent);
+  record.Add("target_precision_percent", static_cast<double>(results.target_precision_percent));
+  record.Add("p90_ns", results.p90_time_nanoseconds);
+  record.Add("p99_ns", results.p99_time_nanoseconds);
+  record.Add("stddev_ns", results.stddev_nanoseconds);
+  record.Add("mad_ns", results.mad_nanoseconds);
+  record.Add("robust_average_ns", results.robust_average_time_nanoseconds);
+  record.Add("outliers_rejected", results.outliers_rejected);
+  record.Add("warmup_iterations", results.warmup_iterations);
+  record.Add("cold_start_ns", results.cold_start_time_nanoseconds);
+  record.Add("steady_state_reached", results.steady_state_reached);
+  record.Add("harness_overhead_ns", results.harness_overhead_nanoseconds);
+  record.Add("harness_submit_overhead_ns", results.harness_submit_overhead_nanoseconds);
+  record.Add("begin_end_overhead_ns", results.begin_end_overhead_nanoseconds);
+  record.Add("harness_overhead_subtracted", results.harness_overhead_subtracted);
+  record.Add("quiescence_ns", results.quiescence_time_nanoseconds);
+
+  const auto &work = results.work_per_iteration;
+  record.BeginObject("work_per_iteration");
+  record.Add("draws", work.draws);
+  record.Add("vertices", work.vertices);
+  record.Add("primitives", work.primitives);
+  record.Add("pixels", work.pixels);
+  record.Add("methods", work.methods);
+  record.EndObject();
+  for (const auto &rate : GetThroughputRates(results)) {
+    record.Add((std::string(rate.first) + "_per_second").c_str(), rate.second);
+  }
+
+  const auto &traffic = results.pushbuffer_traffic;
+  record.Add("pushbuffer_bytes", traffic.bytes);
+  record.Add("pushbuffer_method_headers", traffic.method_headers);
+  record.Add("pushbuffer_methods", traffic.methods);
+  record.Add("begin_end_pairs", traffic.begin_end_pairs);
+  record.Add("pushbuffer_accounting_complete", traffic.complete);
+  if (traffic.methods) {
+    record.Add("us_per_method", results.median_time_nanoseconds / 1000.0 / static_cast<double>(traffic.methods));
+  }
+
+  if (has_submit_times) {
+    record.Add("submit_total_ns", results.total_submit_time_nanoseconds);
+    record.Add("submit_average_ns", results.average_submit_time_nanoseconds);
+    if (include_raw_samples) {
+      record.AddArray("raw_submit_ticks", results.raw_submit_results);
+    }
+  }
+  if (!results.passes.empty()) {
+    record.BeginArray("passes");
+    for (const auto &pass : results.passes) {
+      record.BeginObject();
+      record.Add("pass", pass.pass);
+      record.Add("iterations", pass.iterations);
+      record.Add("median_ns", pass.median_time_nanoseconds);
+      record.Add("robust_average_ns", pass.robust_average_time_nanoseconds);
+      record.Add("cold_start_ns", pass.cold_start_time_nanoseconds);
+      record.Add("quiescence_ns", pass.quiescence_time_nanoseconds);
+      record.EndObject();
+    }
+    record.EndArray();
+  }
+  if (!results.parameters.empty()) {
+    record.BeginObject("parameters");
+    for (const auto &parameter : results.parameters) {
+      record.Add(parameter.first.c_str(), parameter.second);
+    }
+    record.EndObject();
+  }
+  if (!results.tunables.empty()) {
+    record.BeginObject("tunables");
+    for (const auto &tunable : results.tunables) {
+      record.Add(tunable.first.c_str(), tunable.second);
+    }
+    record.EndObject();
+  }
+  if (!results.framebuffer_capture.empty()) {
+    record.Add("framebuffer_capture", results.framebuffer_capture);
+  }
+  if (include_raw_samples) {
+    record.AddArray("raw_ticks", results.raw_results);
+  } else {
+    record.Add("raw_ticks_in_sidecar", true);
+  }
+  record.EndObject();
+
+  return record.str();
+}
+
+//! Returns the pushbuffer address up to which commands have been submitted to the GPU. Commands that pbkit has not yet
+//! submitted are attributed by a later call.
+static const uint32_t *GetPushbufferPut() {
+  const uint32_t put = *reinterpret_cast<const volatile uint32_t *>(kUserDmaPutRegister);
+  return reinterpret_cast<const uint32_t *>(kContiguousMemoryBase | (put & 0x1FFFFFFC));
+}
+
+//! Parses the commands between start and end, following any jump back to the head of the pushbuffer.
+//! Returns false if the span could not be fully parsed.
+static bool AccountPushbufferSpan(const uint32_t *start, const uint32_t *end, TestHost::PushbufferTraffic &traffic) {
+  const uint32_t *cursor = start;
+  bool wrapped = false;
+  uint32_t words_walked = 0;
+
+  while (cursor != end) {
+    if (words_walked > kMaxAccountedSpanWords) {
+      return false;
+    }
+
+    const uint32_t command = *cursor;
+    const bool is_old_jump = (command & 0xE0000003) == 0x20000000;
+    const bool is_jump = (command & 0x03) == 0x01;
+    if (is_old_jump || is_jump) {
+      // If the span wraps and ends beyond its own start, the pushbuffer was overwritten before it could be parsed.
+      if (wrapped || end >= start) {
+        return false;
+      }
+      wrapped = true;
+      cursor = reinterpret_cast<const uint32_t *>(kContiguousMemoryBase | (command & 0x1FFFFFFC));
+      continue;
+    }
+
+    // pbkit never emits calls, and following one would require tracking the matching return.
+    const bool is_call = (command & 0x03) == 0x02;
+    if (is_call) {
+      return false;
+    }
+
+    const uint32_t header_type = command & 0xE0030003;
+    if (header_type != 0x00000000 && header_type != 0x40000000) {
+      // Returns and unknown commands are never emitted by pbkit.
+      return false;
+    }
+
+    const uint32_t count = (command >> 18) & 0x7FF;
+    const uint32_t method = command & 0x1FFC;
+    ++traffic.method_headers;
+    traffic.methods += count;
+    traffic.bytes += (count + 1) * 4;
+    if (method == NV097_SET_BEGIN_END && count && cursor[1] != NV097_SET_BEGIN_END_OP_END) {
+      ++traffic.begin_end_pairs;
+    }
+
+    cursor += count + 1;
+    words_walked += count + 1;
+  }
+
+  return true;
+}
+
+void TestHost::BeginPushbufferAccounting() {
+  // Draining the GPU ensures that every previously emitted command has been submitted, so none are attributed.
+  WaitForGPUIdle(false);
+  pushbuffer_traffic_ = {};
+  accounting_put_ = GetPushbufferPut();
+  accounting_pushbuffer_ = true;
+}
+
+TestHost::PushbufferTraffic TestHost::EndPushbufferAccounting() {
+  // Draining the GPU ensures that every command emitted by the body has been submitted and can be attributed.
+  WaitForGPUIdle(false);
+  AccountPushbufferTraffic();
+  accounting_pushbuffer_ = false;
+  return pushbuffer_traffic_;
+}
+
+void TestHost::AccountPushbufferTraffic() {
+  auto put = GetPushbufferPut();
+  if (!AccountPushbufferSpan(accounting_put_, put, pushbuffer_traffic_)) {
+    pushbuffer_traffic_.complete = false;
+  }
+  accounting_put_ = put;
+}
+
+void TestHost::WaitForGPUIdle(bool trace) {
+  const bool tracing = trace && TraceRecorder::IsEnabled();
+  const uint64_t start = tracing ? TraceRecorder::Now() : 0;
+
+  PBKitPlusPlus::Pushbuffer::Flush();
+  while (pb_busy()) {
+    /* Wait for completion... */
+  }
+
+  if (tracing) {
+    TraceRecorder::AddEvent("gpu_drain", TraceRecorder::InternName("WaitForGPUIdle"), start,
+                            TraceRecorder::Now() - start);
+  }
+}
+
+uint64_t TestHost::Quiesce(uint32_t vblanks) {
+  TraceRecorder::Scope trace_scope("quiescence", "Quiesce");
+  const auto start = ReadTimer();
+
+  WaitForGPUIdle(false);
+  while (pb_finished()) {
+    /* Not ready to swap yet */
+  }
+  for (uint32_t i = 0; i < vblanks; ++i) {
+    pb_wait_for_vbl();
+  }
+
+  return GetTicksSince(start);
+}
+
+const char *TestHost::TimingModeName(TimingMode mode) {
+  switch (mode) {
+    case TimingMode::SUBMIT:
+      return "submit";
+    case TimingMode::GPU_COMPLETION:
+      return "gpu_completion";
+  }
+  return "unknown";
+}
+
 void TestHost::SetupFixedFunctionPassthrough() {
   SetVertexShaderProgram(nullptr);
   SetWindowClip(GetFramebufferWidth(), GetFramebufferHeight());
@@ -162,11 +863,55 @@ void pb_print_with_floats(const char *format, ...) {
   }
 }
 
-[[nodiscard]] uint32_t TestHost::GetMicrosecondsSince(const LARGE_INTEGER &previous) const {
+uint64_t TestHost::ReadTimer() const {
+  if (timer_source_ == TimerSource::RDTSC) {
+    return __builtin_ia32_rdtsc();
+  }
+
   LARGE_INTEGER now;
   QueryPerformanceCounter(&now);
+  return now.QuadPart;
+}
+
+uint64_t TestHost::TicksToNanoseconds(uint64_t ticks) const {
+  // Split the conversion to avoid overflowing when scaling long durations.
+  const uint64_t seconds = ticks / timer_frequency_;
+  const uint64_t remainder = ticks % timer_frequency_;
+  return seconds * 1000000000ULL + (remainder * 1000000000ULL) / timer_frequency_;
+}
 
-  double delta = (double)(now.QuadPart - previous.QuadPart) / perf_counter_frequency_;
-  return static_cast<uint32_t>(delta * 1000000.f);
-  ;
+void TestHost::SetTimerSource(TimerSource source) {
+  timer_source_ = source;
+  if (source == TimerSource::PERFORMANCE_COUNTER) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    timer_frequency_ = frequency.QuadPart;
+    return;
+  }
+
+  // The timestamp counter frequency is not reported by the kernel, so measure it against the performance counter.
+  const auto calibration_ticks =
+      static_cast<LONGLONG>(perf_counter_frequency_ * kTimestampCalibrationMilliseconds / 1000.0);
+  LARGE_INTEGER qpc_start;
+  LARGE_INTEGER qpc_end;
+  QueryPerformanceCounter(&qpc_start);
+  const uint64_t tsc_start = __builtin_ia32_rdtsc();
+  do {
+    QueryPerformanceCounter(&qpc_end);
+  } while (qpc_end.QuadPart - qpc_start.QuadPart < calibration_ticks);
+  const uint64_t tsc_end = __builtin_ia32_rdtsc();
+
+  const double elapsed_seconds = static_cast<double>(qpc_end.QuadPart - qpc_start.QuadPart) / perf_counter_frequency_;
+  timer_frequency_ = static_cast<uint64_t>(static_cast<double>(tsc_end - tsc_start) / elapsed_seconds);
+  PrintMsg("Calibrated timestamp counter at %llu Hz\n", timer_frequency_);
+}
+
+const char *TestHost::TimerSourceName(TimerSource source) {
+  switch (source) {
+    case TimerSource::PERFORMANCE_COUNTER:
+      return "qpc";
+    case TimerSource::RDTSC:
+      return "rdtsc";
+  }
+  return "unknown";
 }
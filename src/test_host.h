@@ -2,22 +2,143 @@
 #define XEMU_PERF_TESTS_TEST_HOST_H
 
 #include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "nv2astate.h"
+#include "trace_recorder.h"
 
 /**
  * Provides utility methods for use by TestSuite subclasses.
  */
 class TestHost : public PBKitPlusPlus::NV2AState {
  public:
+  //! Determines what is measured by TestSuite::Profile.
+  enum class TimingMode {
+    //! Measures only the time taken for the profiled body to return (CPU-side pushbuffer submission).
+    SUBMIT,
+    //! Additionally waits for the GPU to drain after each iteration, measuring the time until PGRAPH is idle.
+    GPU_COMPLETION,
+  };
+
+  //! The clock used to timestamp profiled iterations.
+  enum class TimerSource {
+    //! The kernel performance counter (KeQueryPerformanceCounter).
+    PERFORMANCE_COUNTER,
+    //! The CPU timestamp counter, calibrated against the performance counter.
+    RDTSC,
+  };
+
+  //! Amount of work performed by a single profiled iteration, used to derive throughput rates. Zero values indicate
+  //! that a unit is not meaningful for (or not tracked by) a test.
+  struct WorkUnits {
+    uint64_t draws{0};
+    uint64_t vertices{0};
+    uint64_t primitives{0};
+    //! Number of pixels covered by the rendered geometry.
+    uint64_t pixels{0};
+    //! Number of pushbuffer methods submitted.
+    uint64_t methods{0};
+  };
+
+  //! Pushbuffer traffic emitted by a profiled body (see BeginPushbufferAccounting).
+  struct PushbufferTraffic {
+    //! Bytes of commands written to the pushbuffer, excluding jumps.
+    uint64_t bytes{0};
+    //! Number of method headers.
+    uint64_t method_headers{0};
+    //! Number of method invocations (i.e., parameter words) processed by PFIFO.
+    uint64_t methods{0};
+    uint64_t begin_end_pairs{0};
+    //! False if some traffic could not be attributed, e.g., because it overflowed the pushbuffer in a single span.
+    bool complete{true};
+  };
+
+  //! Summary of a single pass over a test when the test list is repeated (see SetDeferResults).
+  struct PassSummary {
+    uint32_t pass;
+    uint32_t iterations;
+    double median_time_nanoseconds;
+    double robust_average_time_nanoseconds;
+    uint64_t cold_start_time_nanoseconds;
+    uint64_t quiescence_time_nanoseconds;
+  };
+
+  //! Durations are recorded in timer ticks and converted to nanoseconds using timer_frequency.
   struct ProfileResults {
+    TimingMode timing_mode;
+    //! Ticks per second of the timer that produced the raw results.
+    uint64_t timer_frequency;
     uint32_t iterations;
-    uint32_t total_time_microseconds;
-    uint32_t average_time_microseconds;
-    uint32_t maximum_time_microseconds;
-    uint32_t minimum_time_microseconds;
-    std::vector<uint32_t> raw_results;
+    //! Times until the body completed. In GPU_COMPLETION mode this includes waiting for the GPU to become idle.
+    uint64_t total_time_nanoseconds;
+    uint64_t average_time_nanoseconds;
+    uint64_t maximum_time_nanoseconds;
+    uint64_t minimum_time_nanoseconds;
+    //! Per-iteration durations in timer ticks.
+    std::vector<uint64_t> raw_results;
+
+    //! Robust statistics computed from raw_results.
+    double median_time_nanoseconds;
+    double p90_time_nanoseconds;
+    double p99_time_nanoseconds;
+    double stddev_nanoseconds;
+    double mad_nanoseconds;
+    //! Mean of raw_results after discarding outliers (see SampleStatistics::kOutlierThreshold).
+    double robust_average_time_nanoseconds;
+    uint32_t outliers_rejected;
+
+    //! 95% confidence interval of the median time.
+    double median_ci95_low_nanoseconds;
+    double median_ci95_high_nanoseconds;
+    //! Half width of the confidence interval of the median as a percentage of the median.
+    double precision_percent;
+    //! The precision targeted by adaptive profiling, 0 if the iteration count was fixed.
+    float target_precision_percent;
+
+    //! Times until the body returned, regardless of the timing mode.
+    uint64_t total_submit_time_nanoseconds;
+    uint64_t average_submit_time_nanoseconds;
+    //! Per-iteration submission durations in timer ticks.
+    std::vector<uint64_t> raw_submit_results;
+
+    //! Number of untimed iterations executed before profiling, including any used to detect steady state.
+    uint32_t warmup_iterations;
+    //! Time taken by the first warmup iteration, which pays one-time costs such as shader translation.
+    uint64_t cold_start_time_nanoseconds;
+    //! Whether steady state detection was enabled and succeeded before profiling began.
+    bool steady_state_reached;
+
+    //! Calibrated cost of an empty profiled iteration (see TestSuite::CalibrateHarnessOverhead).
+    uint64_t harness_overhead_nanoseconds;
+    //! Calibrated time for an empty profiled body to return, the part of the harness overhead within submit times.
+    uint64_t harness_submit_overhead_nanoseconds;
+    //! Calibrated cost of a Begin/End pair with no vertices, excluding the harness overhead.
+    uint64_t begin_end_overhead_nanoseconds;
+    //! Whether harness_overhead_nanoseconds has been subtracted from every sample (including raw_results), and
+    //! harness_submit_overhead_nanoseconds from every submit sample.
+    bool harness_overhead_subtracted;
+    //! Time spent waiting for the GPU to become idle before the test began (see TestHost::Quiesce).
+    uint64_t quiescence_time_nanoseconds;
+
+    //! Work performed per iteration, declared by the test suite after profiling.
+    WorkUnits work_per_iteration;
+    //! Pushbuffer traffic emitted by a single iteration.
+    PushbufferTraffic pushbuffer_traffic;
+
+    //! Per-pass breakdown when the samples of several passes have been merged into this result.
+    std::vector<PassSummary> passes;
+
+    //! Path of the captured framebuffer image relative to the output directory, empty if no capture was made.
+    std::string framebuffer_capture;
+
+    //! (name, value) of each workload tunable read by the test (see TestSuite::GetTunable).
+    std::vector<std::pair<std::string, uint32_t>> tunables;
+
+    //! (name, value) of each sweepable parameter of the test case (see TestSuite::AddParameterizedTest).
+    std::vector<std::pair<std::string, uint32_t>> parameters;
   };
 
  public:
@@ -27,6 +148,13 @@ class TestHost : public PBKitPlusPlus::NV2AState {
   //! Creates the given directory if it does not already exist.
   static void EnsureFolderExists(const std::string &folder_path);
 
+  //! Clears the framebuffer in preparation for a new frame.
+  template <typename... Args>
+  void PrepareDraw(Args &&...args) {
+    TraceRecorder::Scope trace_scope("draw", "PrepareDraw");
+    NV2AState::PrepareDraw(std::forward<Args>(args)...);
+  }
+
   //! Renders test results and swaps back buffer.
   void FinishDraw(const std::string &suite_name, const std::string &test_name, const ProfileResults &results);
 
@@ -36,8 +164,137 @@ class TestHost : public PBKitPlusPlus::NV2AState {
   [[nodiscard]] bool GetSaveResults() const { return save_results_; }
   void SetSaveResults(bool enable = true) { save_results_ = enable; }
 
+  [[nodiscard]] TimingMode GetTimingMode() const { return timing_mode_; }
+  void SetTimingMode(TimingMode mode) { timing_mode_ = mode; }
+
+  //! Flushes any pending pushbuffer commands and blocks until the GPU is idle.
+  //! The wait is recorded as a trace event unless `trace` is false.
+  static void WaitForGPUIdle(bool trace = true);
+
+  //! Waits for the GPU to become idle, flips the framebuffer, and then waits for the given number of vblanks so that
+  //! work deferred by the emulator (e.g., surface downloads triggered by the flip) completes before a test begins.
+  //! Returns the time taken in timer ticks.
+  uint64_t Quiesce(uint32_t vblanks);
+
+  static const char *TimingModeName(TimingMode mode);
+
+  //! Recomputes the summary fields of the given results from its raw samples.
+  void UpdateSummaryStatistics(ProfileResults &results) const;
+
+  //! When enabled, results are held in memory rather than logged, and the samples from each pass over a test are
+  //! merged into a single result that is written by FlushDeferredResults. If checkpointing, each pass is checkpointed
+  //! as a separate line of the test's checkpoint as soon as it completes (see MergeDeferredPass).
+  void SetDeferResults(bool enable = true) { defer_results_ = enable; }
+  //! Sets the index of the pass over the test list that subsequent results belong to.
+  void SetCurrentPass(uint32_t pass) { current_pass_ = pass; }
+  //! Logs and discards all deferred results.
+  void FlushDeferredResults();
+  /**
+   * Merges a single pass into the deferred result of the given test, as if it had just been recorded.
+   * @param name - The full name of the test.
+   * @param results - The results of the pass, whose `passes` holds its summary.
+   * @param pass_record - The checkpointed record of the pass, retained so that the checkpoint written after a later
+   *                      pass still contains it. Empty if the test is not checkpointed.
+   */
+  void MergeDeferredPass(const std::string &name, const ProfileResults &results, const std::string &pass_record);
+  //! Parses a test_result record with inline raw samples, as written to the checkpoint of a pass. The summary
+  //! statistics are recomputed from the raw samples. Returns false if the record is malformed or was measured with a
+  //! different timer frequency.
+  bool ParseResultRecord(const std::string &record, std::string &name, ProfileResults &results) const;
+
+  [[nodiscard]] bool GetWriteCheckpoints() const { return write_checkpoints_; }
+  //! When enabled, test suites checkpoint the results of each test via SetCheckpointPath.
+  void SetWriteCheckpoints(bool enable = true) { write_checkpoints_ = enable; }
+  //! Sets the path of the file to which subsequently recorded results are checkpointed (see WriteCheckpoint). An
+  //! empty path disables checkpointing.
+  void SetCheckpointPath(const std::string &path) { checkpoint_path_ = path; }
+  //! Atomically replaces the checkpoint at the given path with the given single line results record. If the record
+  //! refers to the raw samples sidecar, `raw_samples` holds its encoded sidecar record and is checkpointed alongside it
+  //! (see CheckpointRawSamplesPath).
+  static void WriteCheckpoint(const std::string &checkpoint_path, const std::string &record,
+                              const std::string &raw_samples);
+  //! Returns the path of the file holding the raw samples sidecar record that accompanies the given checkpoint.
+  static std::string CheckpointRawSamplesPath(const std::string &checkpoint_path);
+
+  [[nodiscard]] bool GetCaptureFramebuffers() const { return capture_framebuffers_; }
+  //! When enabled, FinishDraw saves the final rendered frame of each test (before the results overlay is drawn) to the
+  //! path set by SetFramebufferCapturePath.
+  void SetCaptureFramebuffers(bool enable = true) { capture_framebuffers_ = enable; }
+  //! Sets the path of the PNG file into which the next test's framebuffer is captured.
+  void SetFramebufferCapturePath(const std::string &path) { framebuffer_capture_path_ = path; }
+  //! Saves the contents of the back buffer as a PNG file, returning false on failure.
+  static bool SaveBackBuffer(const std::string &path);
+
+  //! Returns a FATX compatible file name for an artifact of the given test. Characters that are invalid in file names
+  //! are replaced and long names are truncated and disambiguated with a hash of the full name.
+  static std::string MakeArtifactFileName(const std::string &test_name, const char *extension);
+
+  //! Returns (unit name, units per second) for each non-zero work unit, based on the median iteration time.
+  static std::vector<std::pair<const char *, double>> GetThroughputRates(const ProfileResults &results);
+
+  static const char *TimerSourceName(TimerSource source);
+
+  [[nodiscard]] TimerSource GetTimerSource() const { return timer_source_; }
+  //! Selects the clock used for profiling. Selecting RDTSC blocks briefly while its frequency is calibrated.
+  void SetTimerSource(TimerSource source);
+
   [[nodiscard]] const double &GetPerformanceCounterFrequency() const { return perf_counter_frequency_; }
-  [[nodiscard]] uint32_t GetMicrosecondsSince(const LARGE_INTEGER &previous) const;
+
+  //! Returns the current value of the profiling timer.
+  [[nodiscard]] uint64_t ReadTimer() const;
+  //! Returns the number of profiling timer ticks per second.
+  [[nodiscard]] uint64_t GetTimerFrequency() const { return timer_frequency_; }
+  [[nodiscard]] uint64_t GetTicksSince(uint64_t previous) const { return ReadTimer() - previous; }
+  [[nodiscard]] uint64_t TicksToNanoseconds(uint64_t ticks) const;
+  [[nodiscard]] double GetNanosecondsPerTick() const { return 1000000000.0 / static_cast<double>(timer_frequency_); }
+
+  //! Starts attributing pushbuffer traffic emitted through this TestHost. Traffic is measured between calls to the
+  //! instrumented draw helpers below, so callers must not hold a Pushbuffer::Begin block open across them.
+  void BeginPushbufferAccounting();
+  //! Stops pushbuffer accounting and returns the traffic emitted since BeginPushbufferAccounting.
+  PushbufferTraffic EndPushbufferAccounting();
+
+  // The draw helpers are wrapped so that pushbuffer accounting can checkpoint around them, keeping each accounted span
+  // well below the size of the pushbuffer.
+  template <typename... Args>
+  void Begin(Args &&...args) {
+    CheckpointPushbufferAccounting();
+    NV2AState::Begin(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void End(Args &&...args) {
+    CheckpointPushbufferAccounting();
+    NV2AState::End(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void DrawArrays(Args &&...args) {
+    CheckpointPushbufferAccounting();
+    NV2AState::DrawArrays(std::forward<Args>(args)...);
+    CheckpointPushbufferAccounting();
+  }
+
+  template <typename... Args>
+  void DrawInlineBuffer(Args &&...args) {
+    CheckpointPushbufferAccounting();
+    NV2AState::DrawInlineBuffer(std::forward<Args>(args)...);
+    CheckpointPushbufferAccounting();
+  }
+
+  template <typename... Args>
+  void DrawInlineArray(Args &&...args) {
+    CheckpointPushbufferAccounting();
+    NV2AState::DrawInlineArray(std::forward<Args>(args)...);
+    CheckpointPushbufferAccounting();
+  }
+
+  template <typename... Args>
+  void DrawInlineElements16(Args &&...args) {
+    CheckpointPushbufferAccounting();
+    NV2AState::DrawInlineElements16(std::forward<Args>(args)...);
+    CheckpointPushbufferAccounting();
+  }
 
   void PreTest() {
     current_frame_index_ = 0;
@@ -46,8 +303,42 @@ class TestHost : public PBKitPlusPlus::NV2AState {
     average_mspf_ = 0.f;
   }
 
+ private:
+  void CheckpointPushbufferAccounting() {
+    if (accounting_pushbuffer_) {
+      AccountPushbufferTraffic();
+    }
+  }
+  //! Attributes the traffic emitted since the previous checkpoint.
+  void AccountPushbufferTraffic();
+
+  void RecordResults(const std::string &name, const ProfileResults &results);
+  void LogResults(const std::string &name, const ProfileResults &results, const std::string &checkpoint_path) const;
+  //! Returns the single line test_result record for the given results.
+  [[nodiscard]] std::string BuildResultRecord(const std::string &name, const ProfileResults &results,
+                                              bool include_raw_samples) const;
+
  private:
   bool save_results_{true};
+  bool accounting_pushbuffer_{false};
+  const uint32_t *accounting_put_{nullptr};
+  PushbufferTraffic pushbuffer_traffic_;
+
+  bool defer_results_{false};
+  uint32_t current_pass_{0};
+  //! Names of deferred results in the order in which they were first recorded.
+  std::vector<std::string> deferred_result_names_;
+  std::map<std::string, ProfileResults> deferred_results_;
+  //! Map of test name to the checkpointed record of each of its passes.
+  std::map<std::string, std::vector<std::string>> deferred_pass_records_;
+  bool write_checkpoints_{false};
+  std::string checkpoint_path_;
+  bool capture_framebuffers_{false};
+  std::string framebuffer_capture_path_;
+
+  TimingMode timing_mode_{TimingMode::SUBMIT};
+  TimerSource timer_source_{TimerSource::PERFORMANCE_COUNTER};
+  uint64_t timer_frequency_;
 
   static constexpr auto kFrameTimeWindow = 10;
   double perf_counter_frequency_;
@@ -0,0 +1,14 @@
+#ifndef XEMU_PERF_TESTS_TEST_ORDER_H
+#define XEMU_PERF_TESTS_TEST_ORDER_H
+
+//! Determines the order in which tests are executed by TestDriver::RunAllTestsNonInteractive.
+enum class TestOrder {
+  //! Suites and tests are executed in name order.
+  SORTED,
+  //! Each pass executes all tests in a random order.
+  RANDOM,
+  //! Each pass takes one test from each suite in turn, rotating the starting suite between passes.
+  INTERLEAVED,
+};
+
+#endif  // XEMU_PERF_TESTS_TEST_ORDER_H
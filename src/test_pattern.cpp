@@ -0,0 +1,362 @@
+#include "test_pattern.h"
+
+#include <cctype>
+
+static constexpr char kRegexPrefix[] = "re:";
+static constexpr uint32_t kUnbounded = UINT32_MAX;
+
+//! Appends the ranges of the given class escape (e.g., the 'd' of "\d"), returning false if it is not a class escape.
+static bool AddClassEscapeRanges(char escape, std::vector<std::pair<char, char>> &ranges) {
+  switch (escape) {
+    case 'd':
+      ranges.emplace_back('0', '9');
+      return true;
+    case 'w':
+      ranges.emplace_back('a', 'z');
+      ranges.emplace_back('A', 'Z');
+      ranges.emplace_back('0', '9');
+      ranges.emplace_back('_', '_');
+      return true;
+    case 's':
+      ranges.emplace_back(' ', ' ');
+      ranges.emplace_back('\t', '\r');
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool TestPattern::Parse(const std::string &pattern, std::string &error) {
+  source_ = pattern;
+  terms_.clear();
+
+  if (!pattern.compare(0, sizeof(kRegexPrefix) - 1, kRegexPrefix)) {
+    anchored_ = false;
+    return ParseRegex(pattern.substr(sizeof(kRegexPrefix) - 1), error);
+  }
+
+  anchored_ = true;
+  return ParseGlob(pattern, error);
+}
+
+bool TestPattern::ParseGlob(const std::string &glob, std::string &error) {
+  for (size_t pos = 0; pos < glob.size(); ++pos) {
+    Term term;
+    switch (glob[pos]) {
+      case '*':
+        term.type = Term::Type::ANY;
+        term.min_count = 0;
+        term.max_count = kUnbounded;
+        break;
+
+      case '?':
+        term.type = Term::Type::ANY;
+        break;
+
+      case '[':
+        ++pos;
+        if (!ParseCharacterSet(glob, pos, true, term, error)) {
+          return false;
+        }
+        break;
+
+      default:
+        term.literal = glob[pos];
+        break;
+    }
+    terms_.push_back(std::move(term));
+  }
+
+  return true;
+}
+
+bool TestPattern::ParseRegex(const std::string &regex, std::string &error) {
+  Term root;
+  root.type = Term::Type::GROUP;
+
+  size_t pos = 0;
+  if (!ParseAlternatives(regex, pos, root.alternatives, error)) {
+    return false;
+  }
+  if (pos < regex.size()) {
+    error = "unmatched ')' at offset " + std::to_string(pos);
+    return false;
+  }
+
+  terms_.push_back(std::move(root));
+  return true;
+}
+
+bool TestPattern::ParseAlternatives(const std::string &regex, size_t &pos,
+                                    std::vector<std::vector<Term>> &alternatives, std::string &error) {
+  alternatives.emplace_back();
+
+  while (pos < regex.size() && regex[pos] != ')') {
+    if (regex[pos] == '|') {
+      alternatives.emplace_back();
+      ++pos;
+      continue;
+    }
+
+    const auto term_offset = std::to_string(pos);
+    Term term;
+    switch (regex[pos]) {
+      case '.':
+        term.type = Term::Type::ANY;
+        break;
+
+      case '^':
+        term.type = Term::Type::START;
+        break;
+
+      case '$':
+        term.type = Term::Type::END;
+        break;
+
+      case '[':
+        ++pos;
+        if (!ParseCharacterSet(regex, pos, false, term, error)) {
+          return false;
+        }
+        break;
+
+      case '(':
+        ++pos;
+        // Groups never capture, so the non-capturing form is equivalent.
+        if (!regex.compare(pos, 2, "?:")) {
+          pos += 2;
+        }
+        term.type = Term::Type::GROUP;
+        if (!ParseAlternatives(regex, pos, term.alternatives, error)) {
+          return false;
+        }
+        if (pos >= regex.size()) {
+          error = "missing ')' for the group at offset " + term_offset;
+          return false;
+        }
+        break;
+
+      case '\\':
+        if (++pos >= regex.size()) {
+          error = "trailing '\\'";
+          return false;
+        }
+        if (AddClassEscapeRanges(regex[pos], term.ranges)) {
+          term.type = Term::Type::CHARACTER_SET;
+        } else if (AddClassEscapeRanges(static_cast<char>(tolower(regex[pos])), term.ranges)) {
+          term.type = Term::Type::CHARACTER_SET;
+          term.negated = true;
+        } else if (isalnum(regex[pos])) {
+          error = "unsupported escape '\\" + std::string(1, regex[pos]) + "' at offset " + term_offset;
+          return false;
+        } else {
+          term.literal = regex[pos];
+        }
+        break;
+
+      case '*':
+      case '+':
+      case '?':
+        error = "quantifier without a preceding expression at offset " + term_offset;
+        return false;
+
+      case '{':
+        error = "'{' repetition is not supported at offset " + term_offset;
+        return false;
+
+      default:
+        term.literal = regex[pos];
+        break;
+    }
+    ++pos;
+
+    if (pos < regex.size() && (regex[pos] == '*' || regex[pos] == '+' || regex[pos] == '?')) {
+      if (term.type == Term::Type::START || term.type == Term::Type::END) {
+        error = "anchor may not be repeated at offset " + term_offset;
+        return false;
+      }
+      term.min_count = regex[pos] == '+' ? 1 : 0;
+      term.max_count = regex[pos] == '?' ? 1 : kUnbounded;
+      // Each repetition of such a group could match any number of ways, making matching exponential.
+      if (term.max_count > 1 && term.type == Term::Type::GROUP && CanMatchEmpty(term)) {
+        error = "repeated group may match an empty string at offset " + term_offset;
+        return false;
+      }
+      ++pos;
+
+      // Lazy quantifiers match the same set of names, only the extent of the match differs.
+      if (pos < regex.size() && regex[pos] == '?') {
+        ++pos;
+      }
+      if (pos < regex.size() && (regex[pos] == '*' || regex[pos] == '+' || regex[pos] == '?' || regex[pos] == '{')) {
+        error = "nested quantifier at offset " + std::to_string(pos);
+        return false;
+      }
+    }
+
+    alternatives.back().push_back(std::move(term));
+  }
+
+  return true;
+}
+
+bool TestPattern::CanMatchEmpty(const Term &term) {
+  switch (term.type) {
+    case Term::Type::START:
+    case Term::Type::END:
+      return true;
+
+    case Term::Type::GROUP:
+      for (auto &alternative : term.alternatives) {
+        bool alternative_can_match_empty = true;
+        for (auto &alternative_term : alternative) {
+          if (alternative_term.min_count && !CanMatchEmpty(alternative_term)) {
+            alternative_can_match_empty = false;
+            break;
+          }
+        }
+        if (alternative_can_match_empty) {
+          return true;
+        }
+      }
+      return false;
+
+    default:
+      return false;
+  }
+}
+
+bool TestPattern::ParseCharacterSet(const std::string &pattern, size_t &pos, bool glob, Term &term,
+                                    std::string &error) {
+  const auto set_offset = std::to_string(pos - 1);
+  term.type = Term::Type::CHARACTER_SET;
+
+  if (pos < pattern.size() && (pattern[pos] == '^' || (glob && pattern[pos] == '!'))) {
+    term.negated = true;
+    ++pos;
+  }
+
+  // A ']' immediately after the opening bracket is a literal.
+  for (bool first = true; pos < pattern.size(); ++pos, first = false) {
+    char first_char = pattern[pos];
+    if (first_char == ']' && !first) {
+      return true;
+    }
+
+    if (!glob && first_char == '\\' && pos + 1 < pattern.size()) {
+      ++pos;
+      if (AddClassEscapeRanges(pattern[pos], term.ranges)) {
+        continue;
+      }
+      if (isalnum(pattern[pos])) {
+        error = "unsupported escape '\\" + std::string(1, pattern[pos]) + "' in the character set at offset " +
+                set_offset;
+        return false;
+      }
+      first_char = pattern[pos];
+    }
+
+    char last_char = first_char;
+    if (pos + 2 < pattern.size() && pattern[pos + 1] == '-' && pattern[pos + 2] != ']') {
+      last_char = pattern[pos + 2];
+      pos += 2;
+      if (last_char < first_char) {
+        error = "invalid range in the character set at offset " + set_offset;
+        return false;
+      }
+    }
+    term.ranges.emplace_back(first_char, last_char);
+  }
+
+  error = "missing ']' for the character set at offset " + set_offset;
+  return false;
+}
+
+bool TestPattern::Matches(const std::string &name) const {
+  steps_ = 0;
+  if (anchored_) {
+    return MatchSequence(terms_, 0, name, 0, [&name](size_t pos) { return pos == name.size(); });
+  }
+
+  for (size_t start = 0; start <= name.size(); ++start) {
+    if (MatchSequence(terms_, 0, name, start, [](size_t) { return true; })) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TestPattern::MatchSequence(const std::vector<Term> &sequence, size_t index, const std::string &name, size_t pos,
+                                const Continuation &next) const {
+  if (index == sequence.size()) {
+    return next(pos);
+  }
+
+  return MatchTerm(sequence[index], 0, name, pos,
+                   [&](size_t end) { return MatchSequence(sequence, index + 1, name, end, next); });
+}
+
+bool TestPattern::MatchTerm(const Term &term, uint32_t count, const std::string &name, size_t pos,
+                            const Continuation &next) const {
+  // Repetition is greedy, so another repetition is attempted before the rest of the pattern.
+  if (count < term.max_count) {
+    auto repeat = [&](size_t end) {
+      // A repetition that matched nothing cannot make progress, so stop repeating to avoid infinite recursion.
+      if (end == pos) {
+        return count + 1 >= term.min_count && next(end);
+      }
+      return MatchTerm(term, count + 1, name, end, next);
+    };
+    if (MatchOnce(term, name, pos, repeat)) {
+      return true;
+    }
+  }
+
+  return count >= term.min_count && next(pos);
+}
+
+bool TestPattern::MatchOnce(const Term &term, const std::string &name, size_t pos, const Continuation &next) const {
+  // Once the limit is exceeded, every remaining path fails immediately.
+  if (++steps_ > kMaxMatchSteps) {
+    steps_ = kMaxMatchSteps + 1;
+    return false;
+  }
+
+  switch (term.type) {
+    case Term::Type::LITERAL:
+      return pos < name.size() && name[pos] == term.literal && next(pos + 1);
+
+    case Term::Type::ANY:
+      return pos < name.size() && next(pos + 1);
+
+    case Term::Type::CHARACTER_SET: {
+      if (pos >= name.size()) {
+        return false;
+      }
+      bool in_set = false;
+      for (auto &range : term.ranges) {
+        if (name[pos] >= range.first && name[pos] <= range.second) {
+          in_set = true;
+          break;
+        }
+      }
+      return in_set != term.negated && next(pos + 1);
+    }
+
+    case Term::Type::GROUP:
+      for (auto &alternative : term.alternatives) {
+        if (MatchSequence(alternative, 0, name, pos, next)) {
+          return true;
+        }
+      }
+      return false;
+
+    case Term::Type::START:
+      return pos == 0 && next(pos);
+
+    case Term::Type::END:
+      return pos == name.size() && next(pos);
+  }
+
+  return false;
+}
@@ -0,0 +1,91 @@
+#ifndef XEMU_PERF_TESTS_TEST_PATTERN_H
+#define XEMU_PERF_TESTS_TEST_PATTERN_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Matches test names against a glob or regular expression, as used by the "include" and "exclude" config entries.
+ *
+ * Globs must match the entire name and support `*` (any sequence of characters), `?` (any single character), and
+ * `[...]` character sets (negated via a leading `!` or `^`).
+ *
+ * Patterns with the prefix "re:" are regular expressions that may match anywhere in the name (use `^` and `$` to anchor
+ * them). A subset of the ECMAScript syntax is supported: literals, `.`, character sets and the `\d`, `\w`, and `\s`
+ * classes (and their negations), groups, alternation, the `^` and `$` anchors, and the `*`, `+`, and `?` quantifiers.
+ * Groups that may match an empty string cannot be repeated.
+ */
+class TestPattern {
+ public:
+  //! Maximum number of backtracking steps that Matches may take for a single name.
+  static constexpr uint32_t kMaxMatchSteps = 1 << 20;
+
+  /**
+   * Parses the given pattern.
+   * @param pattern - A glob, or a regular expression prefixed with "re:".
+   * @param error - Set to a description of the problem if the pattern is malformed.
+   * @return false if the pattern is malformed.
+   */
+  bool Parse(const std::string &pattern, std::string &error);
+
+  //! Returns true if the given name matches this pattern. Returns false if matching was abandoned because it exceeded
+  //! kMaxMatchSteps, see ExceededStepLimit.
+  [[nodiscard]] bool Matches(const std::string &name) const;
+
+  //! Returns true if the most recent call to Matches was abandoned because the pattern backtracked excessively.
+  [[nodiscard]] bool ExceededStepLimit() const { return steps_ > kMaxMatchSteps; }
+
+  [[nodiscard]] const std::string &Source() const { return source_; }
+
+ private:
+  struct Term {
+    enum class Type {
+      LITERAL,
+      ANY,
+      CHARACTER_SET,
+      GROUP,
+      START,
+      END,
+    };
+
+    Type type{Type::LITERAL};
+    char literal{0};
+    //! Inclusive character ranges matched by a CHARACTER_SET.
+    std::vector<std::pair<char, char>> ranges;
+    bool negated{false};
+    //! Alternative sequences matched by a GROUP.
+    std::vector<std::vector<Term>> alternatives;
+    uint32_t min_count{1};
+    uint32_t max_count{1};
+  };
+
+  using Continuation = std::function<bool(size_t)>;
+
+  bool ParseGlob(const std::string &glob, std::string &error);
+  bool ParseRegex(const std::string &regex, std::string &error);
+  //! Parses a sequence of alternatives up to the end of the pattern or an unmatched ')'.
+  static bool ParseAlternatives(const std::string &regex, size_t &pos, std::vector<std::vector<Term>> &alternatives,
+                                std::string &error);
+  //! Returns true if the given term matches the empty string when it is not repeated.
+  static bool CanMatchEmpty(const Term &term);
+  //! Parses a character set starting after its opening '[', leaving `pos` at the closing ']'.
+  static bool ParseCharacterSet(const std::string &pattern, size_t &pos, bool glob, Term &term, std::string &error);
+
+  bool MatchSequence(const std::vector<Term> &sequence, size_t index, const std::string &name, size_t pos,
+                     const Continuation &next) const;
+  bool MatchTerm(const Term &term, uint32_t count, const std::string &name, size_t pos,
+                 const Continuation &next) const;
+  bool MatchOnce(const Term &term, const std::string &name, size_t pos, const Continuation &next) const;
+
+  std::string source_;
+  std::vector<Term> terms_;
+  //! Whether the pattern must match the entire name rather than any substring.
+  bool anchored_{true};
+  //! Number of terms attempted by the most recent call to Matches.
+  mutable uint32_t steps_{0};
+};
+
+#endif  // XEMU_PERF_TESTS_TEST_PATTERN_H
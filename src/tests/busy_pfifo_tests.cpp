@@ -3,13 +3,21 @@
 #include "test_host.h"
 
 static constexpr char kTestName[] = "PFIFOSaturation";
+static constexpr uint32_t kIterations = 10;
 static constexpr uint32_t kNumBloatCommandsPerDraw = 1900;
 static constexpr uint32_t kNumDrawsSingleFrame = 25;
 static constexpr uint32_t kNumDrawsMultiFrame = 7;
+static constexpr uint32_t kNumPrimitivesPerDraw = 10;
+static constexpr uint32_t kNumVerticesPerDraw = kNumPrimitivesPerDraw + 2;
+// Methods are counted as parameter words, matching PushbufferTraffic::methods. Each bloat command pushes 6 single word
+// methods, and each vertex pushes a 3 word NV097_SET_DIFFUSE_COLOR3F and a 4 word NV097_SET_VERTEX4F, plus a word
+// each for Begin and End.
+static constexpr uint32_t kNumMethodsPerDraw = kNumBloatCommandsPerDraw * 6 + kNumVerticesPerDraw * (3 + 4) + 2;
 
 BusyPfifoTests::BusyPfifoTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "BusyPfifo", config) {
   tests_[kTestName] = [this]() { Test(); };
+  SupportTunables({Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION});
 }
 
 /**
@@ -82,11 +90,11 @@ void BusyPfifoTests::Test() {
 
   TestHost::ProfileResults results{};
 
-  const uint32_t num_draws = host_.GetSaveResults() ? kNumDrawsSingleFrame : kNumDrawsMultiFrame;
-  results = Profile(kTestName, 10, [this, num_draws] {
+  const uint32_t num_draws = host_.GetSaveResults() ? GetTunable(Tunable::DRAWS_PER_ITERATION, kNumDrawsSingleFrame)
+                                                     : ContinuousWorkload(kNumDrawsMultiFrame);
+  results = Profile(kTestName, GetTunable(Tunable::ITERATIONS, kIterations), [this, num_draws] {
     static constexpr float kZ = 1.f;
     static constexpr float kW = 1.f;
-    static constexpr uint32_t kNumPrimitives = 10;
 
     const float screen_w = host_.GetFramebufferWidthF();
     const float screen_h = host_.GetFramebufferHeightF();
@@ -102,8 +110,8 @@ void BusyPfifoTests::Test() {
       FillPFIFO();
 
       host_.Begin(TestHost::PRIMITIVE_TRIANGLE_STRIP);
-      for (uint32_t i = 0; i < kNumPrimitives + 2; ++i) {
-        float x = left + (span_x * (i / 2) / (kNumPrimitives / 2.0f));
+      for (uint32_t i = 0; i < kNumVerticesPerDraw; ++i) {
+        float x = left + (span_x * (i / 2) / (kNumPrimitivesPerDraw / 2.0f));
         float y = (i % 2 == 0) ? top + span_y : top;
         SetVertexColor(host_, i);
         host_.SetVertex(x, y, kZ, kW);
@@ -112,5 +120,12 @@ void BusyPfifoTests::Test() {
     }
   });
 
+  results.work_per_iteration = {
+      .draws = num_draws,
+      .vertices = num_draws * kNumVerticesPerDraw,
+      .primitives = num_draws * kNumPrimitivesPerDraw,
+      .methods = num_draws * kNumMethodsPerDraw,
+  };
+
   host_.FinishDraw(suite_name_, kTestName, results);
 }
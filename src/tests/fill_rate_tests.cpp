@@ -16,8 +16,7 @@ static constexpr uint32_t kDrawCountByTextureMode[] = {
 
 static uint32_t kVertexAttributes = TestHost::POSITION | TestHost::DIFFUSE | TestHost::TEXCOORD0 | TestHost::TEXCOORD1 |
                                     TestHost::TEXCOORD2 | TestHost::TEXCOORD3;
-static constexpr auto kTextureWidth = 128;
-static constexpr auto kTextureHeight = 128;
+static constexpr uint32_t kTextureSize = 128;
 
 static constexpr const char *GetTestName(bool use_texture) {
   return use_texture ? "FillRate-Textured" : "FillRate-Solid";
@@ -28,6 +27,7 @@ FillRateTests::FillRateTests(TestHost &host, std::string output_dir, const Confi
   for (auto use_texture : {false, true}) {
     tests_[GetTestName(use_texture)] = [this, use_texture]() { TestFillRate(use_texture); };
   }
+  SupportTunables({Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION, Tunable::TEXTURE_SIZE});
 }
 
 void FillRateTests::Initialize() {
@@ -36,12 +36,6 @@ void FillRateTests::Initialize() {
   host_.SetFinalCombiner0Just(TestHost::SRC_DIFFUSE);
   host_.SetFinalCombiner1Just(TestHost::SRC_ZERO, true, true);
 
-  PBKitPlusPlus::GenerateSwizzledRGBTestPattern(host_.GetTextureMemoryForStage(0), kTextureWidth, kTextureHeight);
-  PBKitPlusPlus::GenerateRGBRadialATestPattern(host_.GetTextureMemoryForStage(1), kTextureWidth, kTextureHeight);
-  PBKitPlusPlus::GenerateSwizzledRGBRadialGradient(host_.GetTextureMemoryForStage(2), kTextureWidth, kTextureHeight);
-  PBKitPlusPlus::GenerateSwizzledRGBMaxContrastNoisePattern(host_.GetTextureMemoryForStage(3), kTextureWidth,
-                                                            kTextureHeight);
-
   vertex_buffer_ = host_.AllocateVertexBuffer(4);
   auto vertex = vertex_buffer_->Lock();
 
@@ -85,6 +79,7 @@ void FillRateTests::Initialize() {
 
 void FillRateTests::Deinitialize() {
   host_.ClearVertexBuffer();
+  vertex_buffer_.reset();
   TestSuite::Deinitialize();
 }
 
@@ -95,10 +90,18 @@ void FillRateTests::TestFillRate(bool use_texture) {
   host_.SetupFixedFunctionPassthrough();
 
   if (use_texture) {
+    // Textures are generated per test, as their size may be configured for each test.
+    const uint32_t texture_size = GetTunable(Tunable::TEXTURE_SIZE, kTextureSize);
+    PBKitPlusPlus::GenerateSwizzledRGBTestPattern(host_.GetTextureMemoryForStage(0), texture_size, texture_size);
+    PBKitPlusPlus::GenerateRGBRadialATestPattern(host_.GetTextureMemoryForStage(1), texture_size, texture_size);
+    PBKitPlusPlus::GenerateSwizzledRGBRadialGradient(host_.GetTextureMemoryForStage(2), texture_size, texture_size);
+    PBKitPlusPlus::GenerateSwizzledRGBMaxContrastNoisePattern(host_.GetTextureMemoryForStage(3), texture_size,
+                                                              texture_size);
+
     for (auto i = 0; i < 4; ++i) {
       auto &texture_stage = host_.GetTextureStage(i);
       texture_stage.SetFormat(PBKitPlusPlus::GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8B8G8R8));
-      texture_stage.SetTextureDimensions(kTextureWidth, kTextureHeight);
+      texture_stage.SetTextureDimensions(texture_size, texture_size);
       texture_stage.SetUWrap(PBKitPlusPlus::TextureStage::WRAP_REPEAT, false);
       texture_stage.SetVWrap(PBKitPlusPlus::TextureStage::WRAP_MIRROR, false);
       texture_stage.SetEnabled(true);
@@ -142,14 +145,23 @@ void FillRateTests::TestFillRate(bool use_texture) {
   TestHost::ProfileResults results{};
 
   std::string test_name = GetTestName(use_texture);
-  const auto num_draws = host_.GetSaveResults() ? kNumDrawsSingleFrame : kDrawCountByTextureMode[use_texture];
+  const auto num_draws = host_.GetSaveResults() ? GetTunable(Tunable::DRAWS_PER_ITERATION, kNumDrawsSingleFrame)
+                                                 : ContinuousWorkload(kDrawCountByTextureMode[use_texture]);
 
-  results = Profile(test_name, kIterations, [this, num_draws] {
+  results = Profile(test_name, GetTunable(Tunable::ITERATIONS, kIterations), [this, num_draws] {
     for (auto i = 0; i < num_draws; ++i) {
       host_.DrawArrays(kVertexAttributes, TestHost::PRIMITIVE_TRIANGLE_STRIP);
     }
   });
 
+  // Each draw is a full screen quad rendered as a two triangle strip.
+  results.work_per_iteration = {
+      .draws = num_draws,
+      .vertices = num_draws * 4,
+      .primitives = num_draws * 2,
+      .pixels = static_cast<uint64_t>(num_draws) * host_.GetFramebufferWidth() * host_.GetFramebufferHeight(),
+  };
+
   host_.SetShaderStageProgram(TestHost::STAGE_NONE);
   host_.SetTextureStageEnabled(0, false);
   host_.SetTextureStageEnabled(1, false);
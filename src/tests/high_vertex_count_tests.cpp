@@ -12,27 +12,35 @@ using namespace PBKitPlusPlus;
 
 static constexpr char kHighVertexCountTest[] = "HighVtxCount";
 
-static constexpr uint32_t kMaxVertexCountSingleFrame = 0x07FFFF;
+static constexpr char kDrawModeParameter[] = "draw_mode";
+//! Number of vertices rendered per iteration. Not swept by default.
+static constexpr char kVerticesParameter[] = "vertices";
 
-static std::string MakeTestName(const std::string &prefix, HighVertexCountTests::DrawMode draw_mode) {
-  std::string ret = prefix;
+// Array entries per vertex in test = (4 position, 1 weight, 4 diffuse, 4 specular, 2 texcoord0)
+static constexpr uint32_t kArrayEntriesPerVertex = 15;
 
-  switch (draw_mode) {
+// In practice, King of Fighters 2003 seems to be the only game that uses a very large number of array entries, to speed
+// up the tests an arbitrary cap higher than KoF2k3 is selected.
+static constexpr uint32_t kMaxArrayEntriesSingleFrame = 0x07FFFF;
+
+// Geometry is rendered as quads, so fewer vertices would produce an empty draw.
+static constexpr uint32_t kMinVertices = 4;
+// A swept or tuned vertex count is submitted by a single draw, so it may not exceed the DrawArrays limit of 0xFFFF
+// vertices. This also keeps every index addressable by DrawInlineElements16.
+static constexpr uint32_t kMaxVertices = 0xFFFF;
+
+static std::string DrawModeLabel(uint32_t draw_mode) {
+  switch (static_cast<HighVertexCountTests::DrawMode>(draw_mode)) {
     case HighVertexCountTests::DrawMode::DRAW_ARRAYS:
-      ret += "-arrays";
-      break;
+      return "arrays";
     case HighVertexCountTests::DrawMode::DRAW_INLINE_BUFFERS:
-      ret += "-inlinebuffers";
-      break;
+      return "inlinebuffers";
     case HighVertexCountTests::DrawMode::DRAW_INLINE_ARRAYS:
-      ret += "-inlinearrays";
-      break;
+      return "inlinearrays";
     case HighVertexCountTests::DrawMode::DRAW_INLINE_ELEMENTS:
-      ret += "-inlineelements";
-      break;
+      return "inlineelements";
   }
-
-  return ret;
+  return "";
 }
 
 /**
@@ -53,13 +61,24 @@ static std::string MakeTestName(const std::string &prefix, HighVertexCountTests:
  */
 HighVertexCountTests::HighVertexCountTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "High vertex count", config) {
-  for (auto draw_mode : {DrawMode::DRAW_ARRAYS, DrawMode::DRAW_INLINE_BUFFERS, DrawMode::DRAW_INLINE_ARRAYS,
-                         DrawMode::DRAW_INLINE_ELEMENTS}) {
-    std::string name = MakeTestName(kHighVertexCountTest, draw_mode);
-    tests_[name] = [this, name, draw_mode]() { Test(name, draw_mode); };
-  }
+  AddParameterizedTest(kHighVertexCountTest,
+                       {
+                           {kDrawModeParameter,
+                            {static_cast<uint32_t>(DrawMode::DRAW_ARRAYS),
+                             static_cast<uint32_t>(DrawMode::DRAW_INLINE_BUFFERS),
+                             static_cast<uint32_t>(DrawMode::DRAW_INLINE_ARRAYS),
+                             static_cast<uint32_t>(DrawMode::DRAW_INLINE_ELEMENTS)},
+                            DrawModeLabel},
+                           {kVerticesParameter, {}, nullptr, kMinVertices, kMaxVertices},
+                       },
+                       [this](const std::string &name, const ParameterValues &parameters) {
+                         Test(name, static_cast<DrawMode>(parameters.at(kDrawModeParameter)), parameters);
+                       });
+  SupportTunables({Tunable::ITERATIONS, Tunable::VERTEX_TARGET});
+  SetTunableRange(Tunable::VERTEX_TARGET, kMinVertices, kMaxVertices);
 }
 
+//! Creates quads totalling at most `max_vertex_count` vertices.
 static void CreateGeometry(TestHost &host, std::shared_ptr<VertexBuffer> &vertex_buffer,
                            std::vector<uint32_t> &index_buffer, uint32_t max_vertex_count) {
   vertex_buffer.reset();
@@ -72,9 +91,6 @@ static void CreateGeometry(TestHost &host, std::shared_ptr<VertexBuffer> &vertex
   const float framebuffer_width = host.GetFramebufferWidthF();
   const float framebuffer_height = host.GetFramebufferHeightF();
 
-  // Array entries per vertex in test = (4 position, 1 weight, 4 diffuse, 4 specular, 2 texcoord0)
-  static constexpr uint32_t kArrayEntriesPerVertex = 15;
-
   // From King of Fighters 2003, Noah Sky 2 level, at least 0x410FA = 266490 are used, each vertex using 15 entries.
   // static constexpr uint32_t kTargetArrayEntries = 0x410FA;
 
@@ -84,13 +100,9 @@ static void CreateGeometry(TestHost &host, std::shared_ptr<VertexBuffer> &vertex
   // Confirmed on Xbox 1.0 that 0x0FFFFF works for draw methods other than DRAW_ARRAYS.
   // static constexpr uint32_t kTargetArrayEntries = 0x0FFFFF;
 
-  // In practice, King of Fighters 2003 seems to be the only game that uses a very large number, to speed up the tests
-  // an arbitrary cap higher than KoF2k3 is selected.
-  //  static constexpr uint32_t kTargetArrayEntries = 0x07FFFF;
-
-  // Note, this value will also be under the separate DrawArrays limit of 0xFFFF vertices. That may be a general
-  // hardware limit.
-  const uint32_t target_quads = max_vertex_count / (4 * kArrayEntriesPerVertex);
+  // Note, kMaxArrayEntriesSingleFrame / kArrayEntriesPerVertex and kMaxVertices are both within the separate
+  // DrawArrays limit of 0xFFFF vertices. That may be a general hardware limit.
+  const uint32_t target_quads = max_vertex_count / 4;
 
   const auto quads_per_row = static_cast<int>((framebuffer_width - (kInset * 2.f)) / kQuadSize);
   const float bottom_row_y = (framebuffer_height - kQuadSize);
@@ -191,13 +203,10 @@ static void CreateGeometry(TestHost &host, std::shared_ptr<VertexBuffer> &vertex
 void HighVertexCountTests::Initialize() {
   TestSuite::Initialize();
 
-  CreateGeometry(host_, single_frame_geometry_.vertex_buffer, single_frame_geometry_.index_buffer,
-                 kMaxVertexCountSingleFrame);
-
-  auto create = [this](DrawMode mode, uint32_t max_vertex_count) {
+  auto create = [this](DrawMode mode, uint32_t array_entries) {
     auto mode_index = static_cast<int>(mode);
     CreateGeometry(host_, continuous_geometry_[mode_index].vertex_buffer, continuous_geometry_[mode_index].index_buffer,
-                   max_vertex_count);
+                   array_entries / kArrayEntriesPerVertex);
   };
 
   create(DrawMode::DRAW_ARRAYS, 0xF0000);
@@ -209,6 +218,7 @@ void HighVertexCountTests::Initialize() {
 void HighVertexCountTests::Deinitialize() {
   host_.ClearVertexBuffer();
   single_frame_geometry_.reset();
+  single_frame_vertex_target_ = 0;
   for (auto &i : continuous_geometry_) {
     i.reset();
   }
@@ -217,9 +227,20 @@ void HighVertexCountTests::Deinitialize() {
 }
 
 //! Test the arbitrary maximum number of vertices per draw.
-void HighVertexCountTests::Test(const std::string &name, DrawMode draw_mode) {
-  const auto &geometry =
-      host_.GetSaveResults() ? single_frame_geometry_ : continuous_geometry_[static_cast<int>(draw_mode)];
+void HighVertexCountTests::Test(const std::string &name, DrawMode draw_mode, const ParameterValues &parameters) {
+  // A swept vertex count takes precedence in both single frame and continuous mode.
+  uint32_t vertex_target = GetParameter(parameters, kVerticesParameter, 0);
+  if (!vertex_target && host_.GetSaveResults()) {
+    vertex_target = GetTunable(Tunable::VERTEX_TARGET, kMaxArrayEntriesSingleFrame / kArrayEntriesPerVertex);
+  }
+
+  // The single frame geometry is rebuilt whenever the vertex target differs from that of the previous test.
+  if (vertex_target && vertex_target != single_frame_vertex_target_) {
+    CreateGeometry(host_, single_frame_geometry_.vertex_buffer, single_frame_geometry_.index_buffer, vertex_target);
+    single_frame_vertex_target_ = vertex_target;
+  }
+
+  const auto &geometry = vertex_target ? single_frame_geometry_ : continuous_geometry_[static_cast<int>(draw_mode)];
 
   auto shader = std::make_shared<PassthroughVertexShader>();
   host_.SetVertexShaderProgram(shader);
@@ -237,23 +258,34 @@ void HighVertexCountTests::Test(const std::string &name, DrawMode draw_mode) {
   TestHost::ProfileResults results{};
   switch (draw_mode) {
     case DrawMode::DRAW_ARRAYS:
-      results = Profile(name, 100, [this, &attributes] { host_.DrawArrays(attributes, kPrimitive); });
+      results = Profile(name, GetTunable(Tunable::ITERATIONS, 100),
+                        [this, &attributes] { host_.DrawArrays(attributes, kPrimitive); });
       break;
 
     case DrawMode::DRAW_INLINE_BUFFERS:
-      results = Profile(name, 5, [this, &attributes] { host_.DrawInlineBuffer(attributes, kPrimitive); });
+      results = Profile(name, GetTunable(Tunable::ITERATIONS, 5),
+                        [this, &attributes] { host_.DrawInlineBuffer(attributes, kPrimitive); });
       break;
 
     case DrawMode::DRAW_INLINE_ELEMENTS:
-      results = Profile(name, 50, [this, &attributes, &geometry] {
+      results = Profile(name, GetTunable(Tunable::ITERATIONS, 50), [this, &attributes, &geometry] {
         host_.DrawInlineElements16(geometry.index_buffer, attributes, kPrimitive);
       });
       break;
 
     case DrawMode::DRAW_INLINE_ARRAYS:
-      results = Profile(name, 10, [this, &attributes] { host_.DrawInlineArray(attributes, kPrimitive); });
+      results = Profile(name, GetTunable(Tunable::ITERATIONS, 10),
+                        [this, &attributes] { host_.DrawInlineArray(attributes, kPrimitive); });
       break;
   }
 
+  // CreateGeometry emits one index per vertex.
+  const uint64_t num_vertices = geometry.index_buffer.size();
+  results.work_per_iteration = {
+      .draws = 1,
+      .vertices = num_vertices,
+      .primitives = num_vertices / 4,
+  };
+
   host_.FinishDraw(suite_name_, name, results);
 }
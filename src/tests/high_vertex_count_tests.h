@@ -33,7 +33,7 @@ class HighVertexCountTests : public TestSuite {
   void Deinitialize() override;
 
  private:
-  void Test(const std::string &name, DrawMode mode);
+  void Test(const std::string &name, DrawMode mode, const ParameterValues &parameters);
 
  private:
   struct GeometryHolder {
@@ -47,6 +47,8 @@ class HighVertexCountTests : public TestSuite {
   };
 
   GeometryHolder single_frame_geometry_;
+  //! Vertex count that single_frame_geometry_ was created with.
+  uint32_t single_frame_vertex_target_{0};
   GeometryHolder continuous_geometry_[4];
 };
 
@@ -6,9 +6,19 @@
 
 static constexpr char kTestName[] = "PrimitiveType";
 
+static constexpr char kPrimitiveParameter[] = "primitive";
+static constexpr char kVertexShaderParameter[] = "vsh";
+//! Number of primitives rendered per iteration. Not swept by default.
+static constexpr char kPrimitivesParameter[] = "primitives";
+
 static constexpr uint32_t kIterations = 10;
 static constexpr uint32_t kNumPrimitivesSingleFrame = 1000;
 static uint32_t kVertexAttributes = TestHost::POSITION | TestHost::DIFFUSE;
+// Bounds the size of the vertex buffer allocated for a calibrated or swept primitive count.
+static constexpr uint32_t kMaxVertices = 0x20000;
+// The point grid needs at least two rows and columns.
+static constexpr uint32_t kMinSweptPrimitives = 4;
+static constexpr uint32_t kMaxSweptPrimitives = kMaxVertices / 4;
 
 // Measured using a 1.0 devkit, close to the 60 fps limit.
 static constexpr uint32_t kPrimitiveCountByPrimitive[] = {
@@ -19,68 +29,92 @@ static constexpr uint32_t kPrimitiveCountByPrimitive[] = {
     [TestHost::PRIMITIVE_QUAD_STRIP] = 2610,   [TestHost::PRIMITIVE_POLYGON] = 4550,
 };
 
-static std::string MakeTestName(const std::string &prefix, TestHost::DrawPrimitive primitive, bool use_vsh) {
-  std::string ret = prefix;
-
-  switch (primitive) {
+static std::string PrimitiveLabel(uint32_t primitive) {
+  switch (static_cast<TestHost::DrawPrimitive>(primitive)) {
     case TestHost::PRIMITIVE_POINTS:
-      ret += "-Points";
-      break;
+      return "Points";
     case TestHost::PRIMITIVE_LINES:
-      ret += "-Lines";
-      break;
+      return "Lines";
     case TestHost::PRIMITIVE_LINE_LOOP:
-      ret += "-LLoop";
-      break;
+      return "LLoop";
     case TestHost::PRIMITIVE_LINE_STRIP:
-      ret += "-LStrip";
-      break;
+      return "LStrip";
     case TestHost::PRIMITIVE_TRIANGLES:
-      ret += "-Tris";
-      break;
+      return "Tris";
     case TestHost::PRIMITIVE_TRIANGLE_STRIP:
-      ret += "-TriStrip";
-      break;
+      return "TriStrip";
     case TestHost::PRIMITIVE_TRIANGLE_FAN:
-      ret += "-TriFan";
-      break;
+      return "TriFan";
     case TestHost::PRIMITIVE_QUADS:
-      ret += "-Quads";
-      break;
+      return "Quads";
     case TestHost::PRIMITIVE_QUAD_STRIP:
-      ret += "-QuadStrip";
-      break;
+      return "QuadStrip";
     case TestHost::PRIMITIVE_POLYGON:
-      ret += "-Poly";
-      break;
+      return "Poly";
   }
+  return "";
+}
 
-  if (use_vsh) {
-    ret += "-vsh";
+static std::string VertexShaderLabel(uint32_t use_vsh) { return use_vsh ? "vsh" : ""; }
+
+//! Returns the smallest number of primitives for which CreateGeometry produces finite vertex positions.
+static uint32_t MinPrimitives(TestHost::DrawPrimitive primitive) {
+  switch (primitive) {
+    case TestHost::PRIMITIVE_POINTS:
+      return kMinSweptPrimitives;
+    case TestHost::PRIMITIVE_LINES:
+    case TestHost::PRIMITIVE_LINE_LOOP:
+    case TestHost::PRIMITIVE_LINE_STRIP:
+      return 2;
+    case TestHost::PRIMITIVE_POLYGON:
+      return 3;
+    default:
+      return 1;
   }
+}
 
-  return ret;
+//! Returns the largest number of primitives for which CreateGeometry allocates at most kMaxVertices vertices.
+static uint32_t MaxPrimitives(TestHost::DrawPrimitive primitive) {
+  switch (primitive) {
+    case TestHost::PRIMITIVE_LINES:
+      return kMaxVertices / 2 - 1;
+    case TestHost::PRIMITIVE_TRIANGLES:
+      return kMaxVertices / 3;
+    case TestHost::PRIMITIVE_QUADS:
+      return kMaxVertices / 4;
+    case TestHost::PRIMITIVE_QUAD_STRIP:
+      return kMaxVertices / 2 - 1;
+    default:
+      return kMaxVertices - 2;
+  }
 }
 
 PrimitiveTypeTests::PrimitiveTypeTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "PrimitiveType", config) {
-  for (auto primitive : {
-           TestHost::PRIMITIVE_POINTS,
-           TestHost::PRIMITIVE_LINES,
-           TestHost::PRIMITIVE_LINE_LOOP,
-           TestHost::PRIMITIVE_LINE_STRIP,
-           TestHost::PRIMITIVE_TRIANGLES,
-           TestHost::PRIMITIVE_TRIANGLE_STRIP,
-           TestHost::PRIMITIVE_TRIANGLE_FAN,
-           TestHost::PRIMITIVE_QUADS,
-           TestHost::PRIMITIVE_QUAD_STRIP,
-           TestHost::PRIMITIVE_POLYGON,
-       }) {
-    for (auto use_vsh : {false, true}) {
-      std::string name = MakeTestName(kTestName, primitive, use_vsh);
-      tests_[name] = [this, name, primitive, use_vsh]() { Test(name, primitive, use_vsh); };
-    }
-  }
+  AddParameterizedTest(kTestName,
+                       {
+                           {kPrimitiveParameter,
+                            {
+                                TestHost::PRIMITIVE_POINTS,
+                                TestHost::PRIMITIVE_LINES,
+                                TestHost::PRIMITIVE_LINE_LOOP,
+                                TestHost::PRIMITIVE_LINE_STRIP,
+                                TestHost::PRIMITIVE_TRIANGLES,
+                                TestHost::PRIMITIVE_TRIANGLE_STRIP,
+                                TestHost::PRIMITIVE_TRIANGLE_FAN,
+                                TestHost::PRIMITIVE_QUADS,
+                                TestHost::PRIMITIVE_QUAD_STRIP,
+                                TestHost::PRIMITIVE_POLYGON,
+                            },
+                            PrimitiveLabel},
+                           {kVertexShaderParameter, {0, 1}, VertexShaderLabel},
+                           {kPrimitivesParameter, {}, nullptr, kMinSweptPrimitives, kMaxSweptPrimitives},
+                       },
+                       [this](const std::string &name, const ParameterValues &parameters) {
+                         Test(name, static_cast<TestHost::DrawPrimitive>(parameters.at(kPrimitiveParameter)),
+                              parameters.at(kVertexShaderParameter) != 0, parameters);
+                       });
+  SupportTunables({Tunable::ITERATIONS});
 }
 
 /**
@@ -138,7 +172,8 @@ static void SetVertexColor(PBKitPlusPlus::Vertex &vertex, uint32_t index) {
   vertex.SetDiffuse(r, g, b);
 }
 
-static void CreateGeometry(TestHost &host_, TestHost::DrawPrimitive primitive, uint32_t num_primitives) {
+//! Creates a vertex buffer for the given primitive type and returns the number of vertices in it.
+static uint32_t CreateGeometry(TestHost &host_, TestHost::DrawPrimitive primitive, uint32_t num_primitives) {
   static constexpr float kZ = 1.f;
   static constexpr float kW = 1.f;
 
@@ -276,9 +311,12 @@ static void CreateGeometry(TestHost &host_, TestHost::DrawPrimitive primitive, u
       vbuf->Unlock();
     } break;
   }
+
+  return vertex_index;
 }
 
-void PrimitiveTypeTests::Test(const std::string &name, TestHost::DrawPrimitive primitive, bool use_vsh) {
+void PrimitiveTypeTests::Test(const std::string &name, TestHost::DrawPrimitive primitive, bool use_vsh,
+                              const ParameterValues &parameters) {
   host_.PrepareDraw(0xFF222222);
 
   if (use_vsh) {
@@ -291,13 +329,26 @@ void PrimitiveTypeTests::Test(const std::string &name, TestHost::DrawPrimitive p
 
   TestHost::ProfileResults results{};
 
-  const uint32_t num_primitives =
-      host_.GetSaveResults() ? kNumPrimitivesSingleFrame : kPrimitiveCountByPrimitive[primitive];
-  CreateGeometry(host_, primitive, num_primitives);
+  // A swept primitive count takes precedence in both single frame and continuous mode.
+  uint32_t num_primitives = GetParameter(parameters, kPrimitivesParameter, 0);
+  if (!num_primitives) {
+    num_primitives = host_.GetSaveResults() ? kNumPrimitivesSingleFrame
+                                            : ContinuousWorkload(kPrimitiveCountByPrimitive[primitive],
+                                                                 MinPrimitives(primitive), MaxPrimitives(primitive));
+  }
+  const uint32_t num_vertices = CreateGeometry(host_, primitive, num_primitives);
 
-  results = Profile(kTestName, kIterations, [this, primitive] { host_.DrawInlineArray(kVertexAttributes, primitive); });
+  results = Profile(name, GetTunable(Tunable::ITERATIONS, kIterations),
+                    [this, primitive] { host_.DrawInlineArray(kVertexAttributes, primitive); });
 
   host_.ClearVertexBuffer();
 
+  results.work_per_iteration = {
+      .draws = 1,
+      .vertices = num_vertices,
+      // The polygon case renders a single polygon with num_primitives vertices.
+      .primitives = primitive == TestHost::PRIMITIVE_POLYGON ? 1 : num_primitives,
+  };
+
   host_.FinishDraw(suite_name_, name, results);
 }
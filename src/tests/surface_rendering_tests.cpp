@@ -9,12 +9,12 @@ static constexpr uint32_t kIterations = 10;
 static constexpr uint32_t kNumDrawsSingleFrame = 80;
 static constexpr uint32_t kNumDrawsMultiframe60FPS = 40;
 
-static constexpr uint32_t kTextureWidth = 128;
-static constexpr uint32_t kTextureHeight = 128;
+static constexpr uint32_t kTextureSize = 128;
 
 SurfaceRenderingTests::SurfaceRenderingTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "SurfaceRendering", config) {
   tests_[kTestName] = [this]() { Test(); };
+  SupportTunables({Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION, Tunable::TEXTURE_SIZE});
 }
 
 /**
@@ -26,10 +26,6 @@ SurfaceRenderingTests::SurfaceRenderingTests(TestHost &host, std::string output_
 void SurfaceRenderingTests::Initialize() {
   TestSuite::Initialize();
 
-  PBKitPlusPlus::GenerateSwizzledRGBRadialGradient(host_.GetTextureMemoryForStage(2), kTextureWidth, kTextureHeight);
-  PBKitPlusPlus::GenerateSwizzledRGBMaxContrastNoisePattern(host_.GetTextureMemoryForStage(3), kTextureWidth,
-                                                            kTextureHeight);
-
   host_.SetBlend(false);
   host_.SetVertexShaderProgram(nullptr);
 
@@ -79,23 +75,29 @@ void SurfaceRenderingTests::Test() {
   host_.SetupFixedFunctionPassthrough();
   host_.PrepareDraw(0xFF444444);
 
+  // Textures are generated per test, as their size may be configured for each test.
+  const uint32_t texture_size = GetTunable(Tunable::TEXTURE_SIZE, kTextureSize);
+  PBKitPlusPlus::GenerateSwizzledRGBRadialGradient(host_.GetTextureMemoryForStage(2), texture_size, texture_size);
+  PBKitPlusPlus::GenerateSwizzledRGBMaxContrastNoisePattern(host_.GetTextureMemoryForStage(3), texture_size,
+                                                            texture_size);
+
   TestHost::ProfileResults results{};
 
-  auto fill_surface = [this]() {
+  auto fill_surface = [this, texture_size]() {
     host_.SetTextureStageEnabled(0, false);
     host_.SetTextureStageEnabled(1, false);
     auto format = PBKitPlusPlus::GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8B8G8R8);
     for (auto i = 2; i < 4; ++i) {
       auto &texture_stage = host_.GetTextureStage(i);
       texture_stage.SetFormat(format);
-      texture_stage.SetTextureDimensions(kTextureWidth, kTextureHeight);
+      texture_stage.SetTextureDimensions(texture_size, texture_size);
       texture_stage.SetEnabled(true);
     }
     host_.SetupTextureStages();
     host_.SetShaderStageProgram(TestHost::STAGE_NONE, TestHost::STAGE_NONE, TestHost::STAGE_2D_PROJECTIVE,
                                 TestHost::STAGE_2D_PROJECTIVE);
 
-    DrawBiTri(host_, 0.f, 0.f, kTextureWidth, kTextureHeight, PBKitPlusPlus::NV2AState::SRC_TEX2,
+    DrawBiTri(host_, 0.f, 0.f, texture_size, texture_size, PBKitPlusPlus::NV2AState::SRC_TEX2,
               PBKitPlusPlus::NV2AState::SRC_TEX3);
 
     host_.SetTextureStageEnabled(2, false);
@@ -114,31 +116,33 @@ void SurfaceRenderingTests::Test() {
   const float left = center_x - (span_x * 0.5f);
   const float top = center_y - (span_y * 0.5f);
 
-  const uint32_t num_draws = host_.GetSaveResults() ? kNumDrawsSingleFrame : kNumDrawsMultiframe60FPS;
-  results = Profile(kTestName, kIterations, [this, num_draws, &fill_surface, left, top, span_x, span_y] {
+  const uint32_t num_draws = host_.GetSaveResults() ? GetTunable(Tunable::DRAWS_PER_ITERATION, kNumDrawsSingleFrame)
+                                                     : ContinuousWorkload(kNumDrawsMultiframe60FPS);
+  const uint32_t iterations = GetTunable(Tunable::ITERATIONS, kIterations);
+  results = Profile(kTestName, iterations, [this, num_draws, &fill_surface, texture_size, left, top, span_x, span_y] {
     for (auto i = 0; i < num_draws; ++i) {
       host_.RenderToSurfaceStart(host_.GetTextureMemoryForStage(0), PBKitPlusPlus::NV2AState::SCF_A8R8G8B8,
-                                 host_.GetTextureMemoryForStage(1), PBKitPlusPlus::NV2AState::SZF_Z24S8, kTextureWidth,
-                                 kTextureHeight, true);
+                                 host_.GetTextureMemoryForStage(1), PBKitPlusPlus::NV2AState::SZF_Z24S8, texture_size,
+                                 texture_size, true);
       fill_surface();
       host_.RenderToSurfaceEnd();
 
       host_.RenderToSurfaceStart(host_.GetTextureMemoryForStage(1), PBKitPlusPlus::NV2AState::SCF_R5G6B5,
-                                 host_.GetTextureMemoryForStage(0), PBKitPlusPlus::NV2AState::SZF_Z16, kTextureWidth,
-                                 kTextureHeight, true);
+                                 host_.GetTextureMemoryForStage(0), PBKitPlusPlus::NV2AState::SZF_Z16, texture_size,
+                                 texture_size, true);
       fill_surface();
       host_.RenderToSurfaceEnd();
 
       {
         auto &texture_stage = host_.GetTextureStage(0);
         texture_stage.SetFormat(PBKitPlusPlus::GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8R8G8B8));
-        texture_stage.SetTextureDimensions(kTextureWidth, kTextureHeight);
+        texture_stage.SetTextureDimensions(texture_size, texture_size);
         texture_stage.SetEnabled(true);
       }
       {
         auto &texture_stage = host_.GetTextureStage(1);
         texture_stage.SetFormat(PBKitPlusPlus::GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R5G6B5));
-        texture_stage.SetTextureDimensions(kTextureWidth, kTextureHeight);
+        texture_stage.SetTextureDimensions(texture_size, texture_size);
         texture_stage.SetEnabled(true);
       }
       host_.SetupTextureStages();
@@ -154,5 +158,16 @@ void SurfaceRenderingTests::Test() {
     }
   });
 
+  // Each draw fills two offscreen surfaces and then composites them onscreen, each pass rendering a pair of triangles.
+  static constexpr uint32_t kPassesPerDraw = 3;
+  const auto surface_pixels = static_cast<uint64_t>(texture_size) * texture_size;
+  const auto onscreen_pixels = static_cast<uint64_t>(span_x * span_y);
+  results.work_per_iteration = {
+      .draws = num_draws * kPassesPerDraw * 2,
+      .vertices = num_draws * kPassesPerDraw * 6,
+      .primitives = num_draws * kPassesPerDraw * 2,
+      .pixels = num_draws * (surface_pixels * 2 + onscreen_pixels),
+  };
+
   host_.FinishDraw(suite_name_, kTestName, results);
 }
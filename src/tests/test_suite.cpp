@@ -1,12 +1,23 @@
 #include "test_suite.h"
 
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wmacro-redefined"
+#include <windows.h>
+#pragma clang diagnostic pop
+
+#include <algorithm>
 #include <sstream>
+#include <tuple>
 
 #include "debug_output.h"
+#include "json_writer.h"
+#include "logger.h"
 #include "nxdk_ext.h"
 #include "pushbuffer.h"
+#include "statistics.h"
 #include "test_host.h"
 #include "texture_format.h"
+#include "trace_recorder.h"
 #include "xbox_math_matrix.h"
 #include "xbox_math_types.h"
 
@@ -15,8 +26,21 @@ using namespace XboxMath;
 
 #define SET_MASK(mask, val) (((val) << (__builtin_ffs(mask) - 1)) & (mask))
 
+// Number of timed samples used to calibrate each harness overhead measurement.
+static constexpr uint32_t kHarnessCalibrationIterations = 101;
+// Number of frames rendered for each candidate workload during workload calibration.
+static constexpr uint32_t kWorkloadCalibrationSamples = 5;
+// Upper bound on calibrated workloads, guarding against tests whose cost does not scale with the workload.
+static constexpr uint32_t kMaxCalibratedWorkload = 1 << 20;
+// Calibration stops once the search interval is within 1/kWorkloadCalibrationResolution of the workload.
+static constexpr uint32_t kWorkloadCalibrationResolution = 100;
+static constexpr char kCheckpointExtension[] = ".ckpt";
+static constexpr char kFramebufferCaptureExtension[] = ".png";
+// Texture memory allocated by TestHost for each stage only accommodates textures up to this size.
+static constexpr uint32_t kMaxTunableTextureSize = 256;
+
 TestSuite::TestSuite(TestHost& host, std::string output_dir, std::string suite_name, const Config& config)
-    : host_(host), output_dir_(std::move(output_dir)), suite_name_(std::move(suite_name)) {
+    : host_(host), output_dir_(std::move(output_dir)), suite_name_(std::move(suite_name)), config_(config) {
   output_dir_ += "\\";
   output_dir_ += suite_name_;
   std::replace(output_dir_.begin(), output_dir_.end(), ' ', '_');
@@ -38,6 +62,225 @@ void TestSuite::DisableTests(const std::set<std::string>& tests_to_skip) {
   }
 }
 
+const char* TestSuite::TunableName(Tunable tunable) {
+  switch (tunable) {
+    case Tunable::ITERATIONS:
+      return "iterations";
+    case Tunable::DRAWS_PER_ITERATION:
+      return "draws_per_iteration";
+    case Tunable::VERTEX_TARGET:
+      return "vertex_target";
+    case Tunable::TEXTURE_SIZE:
+      return "texture_size";
+  }
+  return "unknown";
+}
+
+bool TestSuite::ParseTunableName(const std::string& name, Tunable& tunable) {
+  for (auto candidate :
+       {Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION, Tunable::VERTEX_TARGET, Tunable::TEXTURE_SIZE}) {
+    if (name == TunableName(candidate)) {
+      tunable = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TestSuite::SetTunableOverrides(const TunableValues& suite_values,
+                                    const std::map<std::string, TunableValues>& test_values,
+                                    std::vector<std::string>& errors) {
+  auto validate = [this, &errors](const TunableValues& values, const std::string& error_message_prefix) {
+    bool ret = true;
+    for (auto& entry : values) {
+      auto error_prefix = error_message_prefix + "[" + TunableName(entry.first) + "]";
+      if (!supported_tunables_.count(entry.first)) {
+        errors.emplace_back(error_prefix + " is not supported by this suite");
+        ret = false;
+      } else if (entry.first == Tunable::TEXTURE_SIZE &&
+                 (entry.second > kMaxTunableTextureSize || (entry.second & (entry.second - 1)))) {
+        errors.emplace_back(error_prefix + " must be a power of two no larger than " +
+                            std::to_string(kMaxTunableTextureSize));
+        ret = false;
+      } else if (entry.first == Tunable::DRAWS_PER_ITERATION || entry.first == Tunable::VERTEX_TARGET) {
+        auto range = tunable_ranges_.find(entry.first);
+        const auto min_value = range == tunable_ranges_.end() ? 1 : range->second.first;
+        const auto max_value = range == tunable_ranges_.end() ? kMaxTunableWorkload : range->second.second;
+        if (entry.second < min_value || entry.second > max_value) {
+          errors.emplace_back(error_prefix + " must be between " + std::to_string(min_value) + " and " +
+                              std::to_string(max_value));
+          ret = false;
+        }
+      }
+    }
+    return ret;
+  };
+
+  const auto suite_error_message_prefix = "test_suites[" + suite_name_ + "]";
+  bool ret = validate(suite_values, suite_error_message_prefix);
+  for (auto& entry : test_values) {
+    ret = validate(entry.second, suite_error_message_prefix + "[" + entry.first + "]") && ret;
+  }
+  if (!ret) {
+    return false;
+  }
+
+  suite_tunables_ = suite_values;
+  test_tunables_ = test_values;
+  return true;
+}
+
+uint32_t TestSuite::GetTunable(Tunable tunable, uint32_t default_value) const {
+  ASSERT(supported_tunables_.count(tunable) && "Tunable must be declared via SupportTunables");
+
+  uint32_t value = default_value;
+  auto suite_entry = suite_tunables_.find(tunable);
+  if (suite_entry != suite_tunables_.end()) {
+    value = suite_entry->second;
+  }
+
+  auto test_entry = test_tunables_.find(current_test_);
+  if (test_entry != test_tunables_.end()) {
+    auto entry = test_entry->second.find(tunable);
+    if (entry != test_entry->second.end()) {
+      value = entry->second;
+    }
+  }
+
+  current_tunables_[tunable] = value;
+  return value;
+}
+
+bool TestSuite::SetSweepOverrides(const std::map<std::string, std::vector<uint32_t>>& sweeps,
+                                  std::vector<std::string>& errors) {
+  bool ret = true;
+  for (auto& sweep : sweeps) {
+    const auto error_prefix = "test_suites[" + suite_name_ + "][sweeps][" + sweep.first + "]";
+    bool found = false;
+    for (auto& definition : parameterized_tests_) {
+      for (auto& axis : definition.axes) {
+        if (axis.name != sweep.first || axis.label) {
+          continue;
+        }
+        found = true;
+        for (auto value : sweep.second) {
+          if (value < axis.min_value || value > axis.max_value) {
+            errors.emplace_back(error_prefix + " value " + std::to_string(value) + " must be between " +
+                                std::to_string(axis.min_value) + " and " + std::to_string(axis.max_value));
+            ret = false;
+            break;
+          }
+        }
+      }
+    }
+    if (!found) {
+      errors.emplace_back(error_prefix + " is not a sweepable parameter of this suite");
+      ret = false;
+    }
+  }
+  if (!ret) {
+    return false;
+  }
+
+  for (auto& definition : parameterized_tests_) {
+    bool modified = false;
+    for (auto& axis : definition.axes) {
+      auto sweep = sweeps.find(axis.name);
+      if (sweep != sweeps.end() && !axis.label) {
+        axis.values = sweep->second;
+        modified = true;
+      }
+    }
+    if (modified) {
+      ExpandParameterizedTest(definition);
+    }
+  }
+  return true;
+}
+
+std::vector<uint32_t> TestSuite::LinearRange(uint32_t start, uint32_t stop, uint32_t step) {
+  ASSERT(step && "Range step must be positive");
+  std::vector<uint32_t> ret;
+  for (uint64_t value = start; value <= stop; value += step) {
+    ret.push_back(static_cast<uint32_t>(value));
+  }
+  return std::move(ret);
+}
+
+std::vector<uint32_t> TestSuite::GeometricRange(uint32_t start, uint32_t stop, uint32_t factor) {
+  ASSERT(start && factor > 1 && "Geometric range must start above 0 and grow by a factor of at least 2");
+  std::vector<uint32_t> ret;
+  for (uint64_t value = start; value <= stop; value *= factor) {
+    ret.push_back(static_cast<uint32_t>(value));
+  }
+  return std::move(ret);
+}
+
+void TestSuite::AddParameterizedTest(const std::string& prefix, std::vector<ParameterAxis> axes,
+                                     ParameterizedTest body) {
+  parameterized_tests_.push_back({prefix, std::move(axes), std::move(body), {}});
+  ExpandParameterizedTest(parameterized_tests_.back());
+}
+
+uint32_t TestSuite::GetParameter(const ParameterValues& parameters, const std::string& name, uint32_t default_value) {
+  auto it = parameters.find(name);
+  return it == parameters.end() ? default_value : it->second;
+}
+
+void TestSuite::ExpandParameterizedTest(ParameterizedTestDefinition& definition) {
+  for (auto& name : definition.test_names) {
+    tests_.erase(name);
+    swept_parameters_.erase(name);
+  }
+  definition.test_names.clear();
+
+  // Visits the Cartesian product of the axis values, varying the last axis fastest. An axis without values
+  // contributes a single case in which the parameter is unset.
+  const auto& axes = definition.axes;
+  std::vector<size_t> indices(axes.size(), 0);
+  bool done = false;
+  while (!done) {
+    std::string name = definition.prefix;
+    ParameterValues parameters;
+    ParameterValues swept_parameters;
+    for (size_t i = 0; i < axes.size(); ++i) {
+      const auto& axis = axes[i];
+      if (axis.values.empty()) {
+        continue;
+      }
+
+      const auto value = axis.values[indices[i]];
+      parameters[axis.name] = value;
+      std::string label;
+      if (axis.label) {
+        label = axis.label(value);
+      } else {
+        label = axis.name + std::to_string(value);
+        swept_parameters[axis.name] = value;
+      }
+      if (!label.empty()) {
+        name += "-" + label;
+      }
+    }
+
+    auto& body = definition.body;
+    tests_[name] = [body, name, parameters]() { body(name, parameters); };
+    if (!swept_parameters.empty()) {
+      swept_parameters_[name] = swept_parameters;
+    }
+    definition.test_names.push_back(name);
+
+    done = true;
+    for (size_t i = axes.size(); i > 0; --i) {
+      if (++indices[i - 1] < axes[i - 1].values.size()) {
+        done = false;
+        break;
+      }
+      indices[i - 1] = 0;
+    }
+  }
+}
+
 void TestSuite::Run(const std::string& test_name, uint32_t frame_count) {
   auto it = tests_.find(test_name);
   if (it == tests_.end()) {
@@ -48,9 +291,43 @@ void TestSuite::Run(const std::string& test_name, uint32_t frame_count) {
     host_.PreTest();
   }
 
-  SetupTest();
-  it->second();
-  TearDownTest();
+  current_test_ = test_name;
+  current_tunables_.clear();
+  if (host_.GetSaveResults()) {
+    TestHost::EnsureFolderExists(output_dir_);
+    host_.SetCheckpointPath(host_.GetWriteCheckpoints() ? CheckpointPath(test_name) : "");
+    host_.SetFramebufferCapturePath(host_.GetCaptureFramebuffers() ? FramebufferCapturePath(test_name) : "");
+
+    // Keep the tail of the previous test (including work xemu deferred until later frames) out of this one.
+    if (config_.delay_milliseconds_between_tests) {
+      TraceRecorder::Scope trace_scope("quiescence", "Cooldown");
+      Sleep(config_.delay_milliseconds_between_tests);
+    }
+    last_quiescence_ticks_ = host_.Quiesce(config_.quiescence_vblanks);
+  }
+
+  {
+    TraceRecorder::Scope trace_scope("test", suite_name_ + "::" + test_name);
+    if (config_.calibrate_workloads && host_.GetSaveResults()) {
+      CalibrateWorkload(test_name, it->second);
+    } else {
+      SetupTest();
+      it->second();
+      TearDownTest();
+    }
+  }
+
+  // Results are only written to disk between tests so that file I/O does not overlap with profiling.
+  Logger::Flush();
+  TraceRecorder::Flush();
+}
+
+std::string TestSuite::CheckpointPath(const std::string& test_name) const {
+  return output_dir_ + "\\" + TestHost::MakeArtifactFileName(test_name, kCheckpointExtension);
+}
+
+std::string TestSuite::FramebufferCapturePath(const std::string& test_name) const {
+  return output_dir_ + "\\" + TestHost::MakeArtifactFileName(test_name, kFramebufferCaptureExtension);
 }
 
 void TestSuite::RunAll() {
@@ -60,6 +337,111 @@ void TestSuite::RunAll() {
   }
 }
 
+uint32_t TestSuite::ContinuousWorkload(uint32_t default_workload, uint32_t min_workload,
+                                       uint32_t max_workload) const {
+  workload_queried_ = true;
+  min_workload_ = min_workload;
+  max_workload_ = max_workload;
+  if (workload_override_) {
+    return std::clamp(workload_override_, min_workload, max_workload);
+  }
+
+  auto it = calibrated_workloads_.find(current_test_);
+  return it == calibrated_workloads_.end() ? default_workload : it->second;
+}
+
+void TestSuite::CalibrateWorkload(const std::string& test_name, const std::function<void(void)>& test) {
+  // Render in continuous mode so that tests use ContinuousWorkload, measuring until the GPU has finished each frame.
+  const auto timing_mode = host_.GetTimingMode();
+  host_.SetSaveResults(false);
+  host_.SetTimingMode(TestHost::TimingMode::GPU_COMPLETION);
+
+  auto measure = [this, &test](uint32_t workload) -> uint64_t {
+    workload_override_ = workload;
+    std::vector<uint64_t> samples;
+    samples.reserve(kWorkloadCalibrationSamples);
+    for (auto i = 0; i < kWorkloadCalibrationSamples; ++i) {
+      SetupTest();
+      test();
+      TearDownTest();
+      samples.push_back(last_iteration_ticks_);
+    }
+    return static_cast<uint64_t>(SampleStatistics::Compute(samples).median);
+  };
+
+  const auto target_ticks = static_cast<uint64_t>(config_.calibration_target_frame_time_milliseconds *
+                                                  static_cast<float>(host_.GetTimerFrequency()) / 1000.f);
+
+  PrintMsg("Calibrating %s::%s\n", suite_name_.c_str(), test_name.c_str());
+  workload_queried_ = false;
+  uint32_t fits = 0;
+  uint64_t fits_ticks = 0;
+  uint32_t exceeds = 0;
+
+  // Grow the workload exponentially until the target is exceeded, then bisect. The first measurement reports the
+  // bounds of the test's workload, to which ContinuousWorkload clamps every workload under evaluation.
+  uint32_t workload = 1;
+  while (true) {
+    auto ticks = measure(workload);
+    if (!workload_queried_) {
+      break;
+    }
+    const uint32_t max_workload = std::min(max_workload_, kMaxCalibratedWorkload);
+    workload = std::clamp(workload, min_workload_, max_workload);
+    if (ticks > target_ticks) {
+      if (workload == min_workload_) {
+        // Even the smallest workload the test can render exceeds the target.
+        fits = workload;
+        fits_ticks = ticks;
+      } else {
+        exceeds = workload;
+      }
+      break;
+    }
+    fits = workload;
+    fits_ticks = ticks;
+    if (workload >= max_workload) {
+      break;
+    }
+    workload = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(workload) * 2, max_workload));
+  }
+
+  if (workload_queried_) {
+    while (exceeds && exceeds - fits > 1 && (exceeds - fits) * kWorkloadCalibrationResolution > fits) {
+      const uint32_t workload = fits + (exceeds - fits) / 2;
+      auto ticks = measure(workload);
+      if (ticks > target_ticks) {
+        exceeds = workload;
+      } else {
+        fits = workload;
+        fits_ticks = ticks;
+      }
+    }
+  }
+
+  workload_override_ = 0;
+  host_.SetTimingMode(timing_mode);
+  host_.SetSaveResults(true);
+
+  if (!workload_queried_) {
+    PrintMsg("  %s::%s does not support workload calibration\n", suite_name_.c_str(), test_name.c_str());
+    return;
+  }
+
+  calibrated_workloads_[test_name] = fits;
+  PrintMsg("  Calibrated workload %u (%llu ns)\n", fits, host_.TicksToNanoseconds(fits_ticks));
+
+  JsonWriter record;
+  record.BeginObject();
+  record.Add("type", "workload_calibration");
+  record.Add("name", suite_name_ + "::" + test_name);
+  record.Add("target_frame_time_ns", host_.TicksToNanoseconds(target_ticks));
+  record.Add("frame_time_ns", host_.TicksToNanoseconds(fits_ticks));
+  record.Add("calibrated_workload", fits);
+  record.EndObject();
+  Logger::Log() << record.str() << std::endl;
+}
+
 void TestSuite::SetDefaultTextureFormat() const {
   const TextureFormatInfo& texture_format = GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_X8R8G8B8);
   host_.SetTextureFormat(texture_format, 0);
@@ -264,60 +646,250 @@ void TestSuite::Initialize() {
   host_.SetShaderStageInput(0, 0);
 
   host_.ClearAllVertexAttributeStrideOverrides();
+
+  CalibrateHarnessOverhead();
+}
+
+uint64_t TestSuite::TimeIteration(const std::function<void(void)>& body, bool wait_for_gpu,
+                                  uint64_t& submit_time) const {
+  const auto iteration_start = host_.ReadTimer();
+  last_iteration_start_ticks_ = iteration_start;
+  body();
+  submit_time = host_.GetTicksSince(iteration_start);
+  if (!wait_for_gpu) {
+    return submit_time;
+  }
+  // The drain is traced by Profile from the iteration timestamps rather than reading the timer again here.
+  TestHost::WaitForGPUIdle(false);
+  return host_.GetTicksSince(iteration_start);
+}
+
+void TestSuite::CalibrateHarnessOverhead() {
+  const auto timing_mode = host_.GetTimingMode();
+  auto cached = calibrated_harness_overheads_.find(timing_mode);
+  if (cached != calibrated_harness_overheads_.end()) {
+    harness_overhead_ = cached->second;
+    return;
+  }
+
+  const bool wait_for_gpu = timing_mode == TestHost::TimingMode::GPU_COMPLETION;
+  TestHost::WaitForGPUIdle();
+
+  // Returns the median iteration and submit times of the given body.
+  auto measure = [this, wait_for_gpu](const std::function<void(void)>& body) -> std::pair<uint64_t, uint64_t> {
+    uint64_t submit_time;
+    // Prime caches and any lazily constructed state before sampling.
+    TimeIteration(body, wait_for_gpu, submit_time);
+
+    std::vector<uint64_t> samples;
+    std::vector<uint64_t> submit_samples;
+    samples.reserve(kHarnessCalibrationIterations);
+    submit_samples.reserve(kHarnessCalibrationIterations);
+    for (auto i = 0; i < kHarnessCalibrationIterations; ++i) {
+      samples.push_back(TimeIteration(body, wait_for_gpu, submit_time));
+      submit_samples.push_back(submit_time);
+    }
+    return {static_cast<uint64_t>(SampleStatistics::Compute(samples).median),
+            static_cast<uint64_t>(SampleStatistics::Compute(submit_samples).median)};
+  };
+
+  HarnessOverhead overhead;
+  std::tie(overhead.iteration_ticks, overhead.submit_ticks) = measure([] {});
+  const auto begin_end = measure([this] {
+    host_.Begin(TestHost::PRIMITIVE_TRIANGLES);
+    host_.End();
+  });
+  overhead.begin_end_ticks =
+      begin_end.first > overhead.iteration_ticks ? begin_end.first - overhead.iteration_ticks : 0;
+
+  harness_overhead_ = overhead;
+  calibrated_harness_overheads_[timing_mode] = overhead;
+
+  PrintMsg("%s harness overhead: %llu ns per iteration (%llu ns submit), %llu ns per Begin/End\n",
+           suite_name_.c_str(), host_.TicksToNanoseconds(overhead.iteration_ticks),
+           host_.TicksToNanoseconds(overhead.submit_ticks), host_.TicksToNanoseconds(overhead.begin_end_ticks));
 }
 
 TestHost::ProfileResults TestSuite::Profile(const std::string& test_name, uint32_t num_iterations,
                                             const std::function<void(void)>& body) const {
+  const auto timing_mode = host_.GetTimingMode();
+  const bool wait_for_gpu = timing_mode == TestHost::TimingMode::GPU_COMPLETION;
+
   TestHost::ProfileResults ret{
+      .timing_mode = timing_mode,
+      .timer_frequency = host_.GetTimerFrequency(),
       .iterations = num_iterations,
-      .total_time_microseconds = 0xFFFFFFFF,
-      .average_time_microseconds = 0xFFFFFFFF,
-      .maximum_time_microseconds = 0,
-      .minimum_time_microseconds = 0xFFFFFFFF,
+      .total_time_nanoseconds = UINT64_MAX,
+      .average_time_nanoseconds = UINT64_MAX,
+      .maximum_time_nanoseconds = 0,
+      .minimum_time_nanoseconds = UINT64_MAX,
+      .total_submit_time_nanoseconds = UINT64_MAX,
+      .average_submit_time_nanoseconds = UINT64_MAX,
   };
 
+  uint32_t num_warmup_iterations = config_.warmup_iterations;
+  uint32_t steady_state_window = config_.steady_state_window;
   if (!host_.GetSaveResults()) {
     num_iterations = 1;
+    num_warmup_iterations = 0;
+    steady_state_window = 0;
+  }
+
+  const bool adaptive = host_.GetSaveResults() && config_.adaptive_target_precision_percent > 0.f;
+  if (adaptive) {
+    num_iterations = std::max(config_.adaptive_min_iterations, 1U);
   }
 
-  auto run_times = std::make_unique<uint32_t[]>(num_iterations);
+  std::vector<uint64_t> run_times;
+  std::vector<uint64_t> submit_times;
+  run_times.reserve(num_iterations);
+  submit_times.reserve(num_iterations);
 
   PrintMsg("Starting %s::%s\n", suite_name_.c_str(), test_name.c_str());
 
-  LARGE_INTEGER profile_start;
-  LARGE_INTEGER iteration_start;
+  // Make sure that work queued before profiling (e.g., PrepareDraw) is not attributed to the first iteration.
+  if (wait_for_gpu) {
+    TestHost::WaitForGPUIdle();
+  }
+
+  // Trace events are recorded between iterations from the timestamps taken by TimeIteration, so tracing does not add
+  // to the measured times.
+  const bool tracing = TraceRecorder::IsEnabled();
+  uint32_t iteration_trace_name = 0;
+  uint32_t gpu_drain_trace_name = 0;
+  if (tracing) {
+    iteration_trace_name = TraceRecorder::InternName(suite_name_ + "::" + test_name);
+    gpu_drain_trace_name = TraceRecorder::InternName("GPU drain");
+  }
+
+  // Returns the duration of the iteration in timer ticks.
+  auto run_iteration = [this, &body, wait_for_gpu, tracing, iteration_trace_name, gpu_drain_trace_name](
+                           const char* trace_category, uint32_t index, uint64_t& submit_time) -> uint64_t {
+    auto time = TimeIteration(body, wait_for_gpu, submit_time);
+    if (tracing) {
+      const auto start = last_iteration_start_ticks_;
+      TraceRecorder::AddEvent(trace_category, iteration_trace_name, start, time, static_cast<int32_t>(index));
+      if (wait_for_gpu) {
+        TraceRecorder::AddEvent("gpu_drain", gpu_drain_trace_name, start + submit_time, time - submit_time,
+                                static_cast<int32_t>(index));
+      }
+    }
+    return time;
+  };
+
+  uint64_t ignored_submit_time;
+  std::vector<uint64_t> warmup_times;
+  auto run_warmup_iteration = [&]() {
+    auto time = run_iteration("warmup", ret.warmup_iterations, ignored_submit_time);
+    if (!ret.warmup_iterations++) {
+      // The cold start iteration is reported separately and is never representative of steady state.
+      ret.cold_start_time_nanoseconds = host_.TicksToNanoseconds(time);
+    } else {
+      warmup_times.push_back(time);
+    }
+  };
+
+  for (auto i = 0; i < num_warmup_iterations; ++i) {
+    run_warmup_iteration();
+  }
+
+  if (steady_state_window) {
+    auto is_steady = [&warmup_times, steady_state_window, this]() {
+      if (warmup_times.size() < steady_state_window) {
+        return false;
+      }
+      std::vector<uint64_t> window(warmup_times.end() - steady_state_window, warmup_times.end());
+      auto stats = SampleStatistics::Compute(window);
+      return stats.mean > 0.0 && stats.stddev / stats.mean < config_.steady_state_cv_threshold;
+    };
+
+    for (uint32_t i = 0;; ++i) {
+      if (is_steady()) {
+        ret.steady_state_reached = true;
+        break;
+      }
+      if (i >= config_.max_steady_state_iterations) {
+        PrintMsg("  Steady state not reached after %u additional warmup iterations\n", i);
+        break;
+      }
+      run_warmup_iteration();
+    }
+  }
 
-  QueryPerformanceCounter(&profile_start);
+  const auto profile_start = host_.ReadTimer();
+
+  auto run_timed_iteration = [&run_iteration, &run_times, &submit_times]() {
+    uint64_t submit_time;
+    run_times.push_back(run_iteration("iteration", run_times.size(), submit_time));
+    submit_times.push_back(submit_time);
+  };
 
   for (auto i = 0; i < num_iterations; ++i) {
-    QueryPerformanceCounter(&iteration_start);
-    body();
-    run_times[i] = host_.GetMicrosecondsSince(iteration_start);
+    run_timed_iteration();
   }
 
-  auto duration = host_.GetMicrosecondsSince(profile_start);
+  if (adaptive) {
+    const uint64_t time_budget_ticks =
+        static_cast<uint64_t>(config_.adaptive_time_budget_milliseconds) * host_.GetTimerFrequency() / 1000;
+    while (run_times.size() < config_.adaptive_max_iterations) {
+      auto stats = SampleStatistics::Compute(run_times);
+      if (stats.MedianPrecisionPercent() <= config_.adaptive_target_precision_percent) {
+        break;
+      }
+      if (host_.GetTicksSince(profile_start) >= time_budget_ticks) {
+        PrintMsg("  Time budget exhausted at %f%% precision\n", stats.MedianPrecisionPercent());
+        break;
+      }
+      run_timed_iteration();
+    }
+    num_iterations = run_times.size();
+  }
+
+  auto duration = host_.TicksToNanoseconds(host_.GetTicksSince(profile_start));
 
   PrintMsg("  Completed '%s::%s' in %fms\n", suite_name_.c_str(), test_name.c_str(),
-           static_cast<double>(duration) / 1000.f);
+           static_cast<double>(duration) / 1000000.0);
+
+  last_iteration_ticks_ = run_times.empty() ? 0 : run_times.back();
 
   if (!host_.GetSaveResults()) {
     return ret;
   }
 
+  // Attribute the pushbuffer traffic of one additional, untimed iteration, as the accounting is not free.
+  host_.BeginPushbufferAccounting();
+  body();
+  ret.pushbuffer_traffic = host_.EndPushbufferAccounting();
+  if (wait_for_gpu) {
+    TestHost::WaitForGPUIdle();
+  }
+
   ret.iterations = num_iterations;
-  ret.total_time_microseconds = 0;
-  for (auto i = 0; i < num_iterations; ++i) {
-    auto time = run_times[i];
-    ret.raw_results.emplace_back(time);
-    ret.total_time_microseconds += time;
-    if (time < ret.minimum_time_microseconds) {
-      ret.minimum_time_microseconds = time;
-    }
-    if (time > ret.maximum_time_microseconds) {
-      ret.maximum_time_microseconds = time;
-    }
+  ret.harness_overhead_nanoseconds = host_.TicksToNanoseconds(harness_overhead_.iteration_ticks);
+  ret.harness_submit_overhead_nanoseconds = host_.TicksToNanoseconds(harness_overhead_.submit_ticks);
+  ret.begin_end_overhead_nanoseconds = host_.TicksToNanoseconds(harness_overhead_.begin_end_ticks);
+  ret.quiescence_time_nanoseconds = host_.TicksToNanoseconds(last_quiescence_ticks_);
+  if (config_.subtract_harness_overhead) {
+    ret.harness_overhead_subtracted = true;
+    // In GPU completion mode the iteration overhead includes an idle drain, which submit times do not.
+    auto subtract_overhead = [](uint64_t overhead) {
+      return [overhead](uint64_t& ticks) { ticks = ticks > overhead ? ticks - overhead : 0; };
+    };
+    std::for_each(run_times.begin(), run_times.end(), subtract_overhead(harness_overhead_.iteration_ticks));
+    std::for_each(submit_times.begin(), submit_times.end(), subtract_overhead(harness_overhead_.submit_ticks));
+  }
+  ret.raw_results = run_times;
+  ret.raw_submit_results = submit_times;
+
+  ret.target_precision_percent = adaptive ? config_.adaptive_target_precision_percent : 0.f;
+  for (auto& entry : current_tunables_) {
+    ret.tunables.emplace_back(TunableName(entry.first), entry.second);
+  }
+  auto parameters = swept_parameters_.find(current_test_);
+  if (parameters != swept_parameters_.end()) {
+    ret.parameters.assign(parameters->second.begin(), parameters->second.end());
   }
-  ret.average_time_microseconds = ret.total_time_microseconds / num_iterations;
+  host_.UpdateSummaryStatistics(ret);
 
   return ret;
 }
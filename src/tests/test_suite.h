@@ -16,7 +16,77 @@
 class TestSuite {
  public:
   //! Runtime configuration for TestSuites.
-  struct Config {};
+  struct Config {
+    //! Number of untimed iterations executed before profiling begins. The first is reported as the cold start cost.
+    uint32_t warmup_iterations{1};
+    //! Number of samples in the sliding window used to detect steady state after the warmup iterations. 0 disables
+    //! steady state detection.
+    uint32_t steady_state_window{0};
+    //! Coefficient of variation (stddev / mean) of the sliding window below which execution is considered steady.
+    float steady_state_cv_threshold{0.05f};
+    //! Maximum number of additional untimed iterations to execute while waiting for steady state.
+    uint32_t max_steady_state_iterations{50};
+
+    //! When non-zero, Profile ignores the requested iteration count and instead iterates until the 95% confidence
+    //! interval of the median is within this percentage of the median, or the time budget is exhausted.
+    float adaptive_target_precision_percent{0.f};
+    //! Minimum number of timed iterations in adaptive mode.
+    uint32_t adaptive_min_iterations{5};
+    //! Maximum number of timed iterations in adaptive mode.
+    uint32_t adaptive_max_iterations{1000};
+    //! Maximum time that may be spent on timed iterations of a single test in adaptive mode.
+    uint32_t adaptive_time_budget_milliseconds{10000};
+
+    //! When true, the calibrated cost of an empty profiled iteration is subtracted from every timed sample.
+    bool subtract_harness_overhead{false};
+
+    //! When true, tests are not profiled. Instead, the largest continuous mode workload that can be completed within
+    //! `calibration_target_frame_time_milliseconds` is discovered and logged for each test.
+    bool calibrate_workloads{false};
+    float calibration_target_frame_time_milliseconds{16.6f};
+
+    //! Time to sleep before each test, allowing the host to cool down between tests.
+    uint32_t delay_milliseconds_between_tests{0};
+    //! Number of vblanks to wait for after the GPU has drained and the framebuffer has been flipped before each test.
+    uint32_t quiescence_vblanks{2};
+  };
+
+  //! Workload parameters that a suite may expose for adjustment via the "test_suites" section of the config file.
+  enum class Tunable {
+    //! Number of timed iterations passed to Profile.
+    ITERATIONS,
+    //! Number of draws rendered by each profiled iteration.
+    DRAWS_PER_ITERATION,
+    //! Number of vertices rendered by each profiled iteration.
+    VERTEX_TARGET,
+    //! Width and height of the textures used by the test.
+    TEXTURE_SIZE,
+  };
+
+  //! Map of tunable to configured value.
+  using TunableValues = std::map<Tunable, uint32_t>;
+
+  //! Map of parameter name to value, identifying a single case of a parameterized test.
+  using ParameterValues = std::map<std::string, uint32_t>;
+
+  //! A parameter over which a parameterized test is expanded.
+  struct ParameterAxis {
+    //! Name of the parameter, as used in test names and in the "sweeps" section of the config file.
+    std::string name;
+    //! Values of the parameter. If empty, the parameter is left unset and tests use their built-in default.
+    std::vector<uint32_t> values;
+    //! Returns the component of the test name for the given value, or an empty string to omit it from the name.
+    //! If unset, the component is the parameter name followed by the value (e.g., "draws100") and the values may be
+    //! overridden via the config file.
+    std::function<std::string(uint32_t)> label;
+    //! Smallest value that may be given via the config file.
+    uint32_t min_value{0};
+    //! Largest value that may be given via the config file.
+    uint32_t max_value{UINT32_MAX};
+  };
+
+  //! Body of a parameterized test, invoked with the name and parameter values of a single case.
+  using ParameterizedTest = std::function<void(const std::string &, const ParameterValues &)>;
 
  public:
   TestSuite() = delete;
@@ -28,7 +98,8 @@ class TestSuite {
   //! Called to initialize the test suite.
   virtual void Initialize();
 
-  //! Called to tear down the test suite.
+  //! Called to tear down the test suite. Suites may be initialized again afterwards, so this must release anything that
+  //! Initialize builds up.
   virtual void Deinitialize() {}
 
   //! Called before running an individual test within this suite.
@@ -41,26 +112,168 @@ class TestSuite {
 
   void DisableTests(const std::set<std::string> &tests_to_skip);
 
+  //! Returns the name of the given tunable as used in the config file.
+  static const char *TunableName(Tunable tunable);
+  //! Parses the config file name of a tunable, returning false if the name is not recognized.
+  static bool ParseTunableName(const std::string &name, Tunable &tunable);
+
+  /**
+   * Overrides the default values of tunables for every test in this suite and for individual tests.
+   * @param suite_values - Values applied to every test in the suite.
+   * @param test_values - Map of test name to values for that test, taking precedence over suite_values.
+   * @param errors - Vector of strings into which any error messages will be placed.
+   * @return false if a value targets a tunable that this suite does not support or is out of range.
+   */
+  bool SetTunableOverrides(const TunableValues &suite_values, const std::map<std::string, TunableValues> &test_values,
+                           std::vector<std::string> &errors);
+
+  /**
+   * Replaces the values of sweepable parameters and regenerates the affected tests. Must be called before any tests
+   * are disabled.
+   * @param sweeps - Map of parameter name to the values over which it should be swept.
+   * @param errors - Vector of strings into which any error messages will be placed.
+   * @return false if a parameter is not a sweepable parameter of any test in this suite or a value is out of range.
+   */
+  bool SetSweepOverrides(const std::map<std::string, std::vector<uint32_t>> &sweeps, std::vector<std::string> &errors);
+
+  //! Returns the values from `start` to `stop` inclusive, incrementing by `step`.
+  static std::vector<uint32_t> LinearRange(uint32_t start, uint32_t stop, uint32_t step);
+  //! Returns the values from `start` to `stop` inclusive, multiplying by `factor`.
+  static std::vector<uint32_t> GeometricRange(uint32_t start, uint32_t stop, uint32_t factor);
+
   [[nodiscard]] std::vector<std::string> TestNames() const;
   [[nodiscard]] bool HasEnabledTests() const { return !tests_.empty(); };
 
   void Run(const std::string &test_name, uint32_t frame_count);
 
+  //! Returns the path of the file into which the results of the given test are checkpointed.
+  [[nodiscard]] std::string CheckpointPath(const std::string &test_name) const;
+  //! Returns the path of the image into which the framebuffer of the given test is captured.
+  [[nodiscard]] std::string FramebufferCapturePath(const std::string &test_name) const;
+
   void RunAll();
 
   //! General purpose +1/-1 callback allowing user interaction via the left/right DPAD.
   virtual void UpdateUserContext(int direction) {};
 
  protected:
+  //! Default upper bound of the draws_per_iteration and vertex_target tunables and of swept draw counts, keeping a
+  //! single iteration well below the duration of a frame.
+  static constexpr uint32_t kMaxTunableWorkload = 100000;
+
   //! Runs the given body function a number of times and calculates profiling information.
+  //! The body is first executed `config_.warmup_iterations` times (and optionally until steady state is detected)
+  //! without contributing to the results.
   TestHost::ProfileResults Profile(const std::string &test_name, uint32_t num_iterations,
                                    const std::function<void(void)> &body) const;
   void SetDefaultTextureFormat() const;
 
+  //! Returns the size of the workload (e.g., number of draws) to render per frame in continuous mode. The given
+  //! default is used unless a workload has been calibrated for the current test (see Config::calibrate_workloads).
+  //! Calibration only evaluates workloads between `min_workload` and `max_workload`, which should be the smallest
+  //! workload the test can render and the largest that it can allocate memory for.
+  uint32_t ContinuousWorkload(uint32_t default_workload, uint32_t min_workload = 1,
+                              uint32_t max_workload = UINT32_MAX) const;
+
+  //! Measures the cost of the profiling harness itself (an empty body) and of a trivial Begin/End pair for the current
+  //! timing mode. Each timing mode is only measured once, later calls reuse the cached calibration.
+  void CalibrateHarnessOverhead();
+
+  //! Declares the tunables that the tests in this suite read via GetTunable. Must be called from the constructor.
+  void SupportTunables(std::initializer_list<Tunable> tunables) { supported_tunables_.insert(tunables); }
+
+  //! Restricts the values of the draws_per_iteration or vertex_target tunable that may be given via the config file.
+  //! By default, values between 1 and 100000 are accepted.
+  void SetTunableRange(Tunable tunable, uint32_t min_value, uint32_t max_value) {
+    tunable_ranges_[tunable] = {min_value, max_value};
+  }
+
+  //! Returns the configured value of the given tunable for the current test, or `default_value` if it has not been
+  //! overridden. The resolved value is recorded with the test's results.
+  uint32_t GetTunable(Tunable tunable, uint32_t default_value) const;
+
+  /**
+   * Registers a test case for every combination of the values of the given axes. Each case is named by appending the
+   * label of each of its parameter values to `prefix`, separated by "-".
+   * @param prefix - The name shared by every case of the test.
+   * @param axes - The parameters over which the test is expanded, ordered as they appear in test names.
+   * @param body - The test, invoked with the name and parameter values of the case being executed.
+   */
+  void AddParameterizedTest(const std::string &prefix, std::vector<ParameterAxis> axes, ParameterizedTest body);
+
+  //! Returns the value of the given parameter, or `default_value` if it is not set for the case.
+  static uint32_t GetParameter(const ParameterValues &parameters, const std::string &name, uint32_t default_value);
+
+ private:
+  //! Calibrated costs of the profiling harness, in timer ticks.
+  struct HarnessOverhead {
+    //! Median duration of an empty profiled iteration.
+    uint64_t iteration_ticks{0};
+    //! Median time for an empty body to return, the harness overhead included in submit times.
+    uint64_t submit_ticks{0};
+    //! Median duration of a Begin/End pair with no vertices beyond the harness overhead.
+    uint64_t begin_end_ticks{0};
+  };
+
+  struct ParameterizedTestDefinition {
+    std::string prefix;
+    std::vector<ParameterAxis> axes;
+    ParameterizedTest body;
+    //! Names of the test cases most recently generated from this definition.
+    std::vector<std::string> test_names;
+  };
+
+  //! (Re)generates the test cases for the given definition.
+  void ExpandParameterizedTest(ParameterizedTestDefinition &definition);
+
+  //! Times a single execution of the given body, returning the duration in timer ticks.
+  //! `submit_time` is set to the time taken for the body to return.
+  uint64_t TimeIteration(const std::function<void(void)> &body, bool wait_for_gpu, uint64_t &submit_time) const;
+
+  //! Binary searches for the largest continuous mode workload for the given test that fits the target frame time.
+  void CalibrateWorkload(const std::string &test_name, const std::function<void(void)> &test);
+
  protected:
   TestHost &host_;
   std::string output_dir_;
   std::string suite_name_;
+  Config config_;
+
+  //! Harness overhead for the current timing mode.
+  HarnessOverhead harness_overhead_;
+  //! Map of timing mode to the harness overhead calibrated for it.
+  std::map<TestHost::TimingMode, HarnessOverhead> calibrated_harness_overheads_;
+
+  //! The name of the test currently being executed.
+  std::string current_test_;
+  //! Map of test name to the continuous mode workload discovered by CalibrateWorkload.
+  std::map<std::string, uint32_t> calibrated_workloads_;
+  //! Workload under evaluation by CalibrateWorkload, 0 if calibration is not in progress.
+  uint32_t workload_override_{0};
+  //! Set when the current test calls ContinuousWorkload, indicating that its workload may be calibrated.
+  mutable bool workload_queried_{false};
+  //! Bounds of the workload of the current test, as most recently passed to ContinuousWorkload.
+  mutable uint32_t min_workload_{1};
+  mutable uint32_t max_workload_{UINT32_MAX};
+  //! Duration of the most recent profiled iteration, in timer ticks.
+  mutable uint64_t last_iteration_ticks_{0};
+  //! Time taken by TestHost::Quiesce before the current test, in timer ticks.
+  uint64_t last_quiescence_ticks_{0};
+  //! Timer value at the start of the most recent iteration timed by TimeIteration.
+  mutable uint64_t last_iteration_start_ticks_{0};
+
+  std::set<Tunable> supported_tunables_;
+  //! Map of tunable to the inclusive range of values accepted from the config file, see SetTunableRange.
+  std::map<Tunable, std::pair<uint32_t, uint32_t>> tunable_ranges_;
+  TunableValues suite_tunables_;
+  //! Map of test name to tunable overrides for that test.
+  std::map<std::string, TunableValues> test_tunables_;
+  //! Tunables read by the current test, as resolved by GetTunable.
+  mutable TunableValues current_tunables_;
+
+  std::vector<ParameterizedTestDefinition> parameterized_tests_;
+  //! Map of test name to the values of the sweepable parameters of that test, recorded with its results.
+  std::map<std::string, ParameterValues> swept_parameters_;
 
   // Map of `test_name` to `void test()`
   std::map<std::string, std::function<void(void)>> tests_{};
@@ -5,8 +5,15 @@
 
 static constexpr char kTinyDrawTest[] = "TinyDraw";
 
+static constexpr char kDrawModeParameter[] = "draw_mode";
+static constexpr char kVertexShaderParameter[] = "vsh";
+//! Number of draws per iteration. Not swept by default.
+static constexpr char kDrawsParameter[] = "draws";
+
 static constexpr uint32_t kIterations = 10;
 static constexpr uint32_t kNumDrawsSingleFrame = 1000;
+// Area of the triangle created in Initialize.
+static constexpr uint32_t kPixelsPerDraw = 8;
 
 // Measured using a 1.0 devkit, close to the 60 fps limit.
 static constexpr uint32_t GetNumDrawsForMode(TinyDrawTests::DrawMode mode) {
@@ -26,40 +33,40 @@ static constexpr uint32_t GetNumDrawsForMode(TinyDrawTests::DrawMode mode) {
 static uint32_t kVertexAttributes = TestHost::POSITION | TestHost::DIFFUSE;
 static TestHost::DrawPrimitive kPrimitive = TestHost::PRIMITIVE_TRIANGLES;
 
-static std::string MakeTestName(const std::string &prefix, TinyDrawTests::DrawMode draw_mode, bool use_vsh) {
-  std::string ret = prefix;
-
-  switch (draw_mode) {
+static std::string DrawModeLabel(uint32_t draw_mode) {
+  switch (static_cast<TinyDrawTests::DrawMode>(draw_mode)) {
     case TinyDrawTests::DrawMode::DRAW_ARRAYS:
-      ret += "-arrays";
-      break;
+      return "arrays";
     case TinyDrawTests::DrawMode::DRAW_INLINE_BUFFERS:
-      ret += "-inlinebuffers";
-      break;
+      return "inlinebuffers";
     case TinyDrawTests::DrawMode::DRAW_INLINE_ARRAYS:
-      ret += "-inlinearrays";
-      break;
+      return "inlinearrays";
     case TinyDrawTests::DrawMode::DRAW_INLINE_ELEMENTS:
-      ret += "-inlineelements";
-      break;
+      return "inlineelements";
   }
-
-  if (use_vsh) {
-    ret += "-vsh";
-  }
-
-  return ret;
+  return "";
 }
 
+static std::string VertexShaderLabel(uint32_t use_vsh) { return use_vsh ? "vsh" : ""; }
+
 TinyDrawTests::TinyDrawTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "TinyDraw", config) {
-  for (auto draw_mode : {DrawMode::DRAW_ARRAYS, DrawMode::DRAW_INLINE_BUFFERS, DrawMode::DRAW_INLINE_ARRAYS,
-                         DrawMode::DRAW_INLINE_ELEMENTS}) {
-    for (auto use_vsh : {false, true}) {
-      std::string name = MakeTestName(kTinyDrawTest, draw_mode, use_vsh);
-      tests_[name] = [this, name, draw_mode, use_vsh]() { Test(name, draw_mode, use_vsh); };
-    }
-  }
+  AddParameterizedTest(kTinyDrawTest,
+                       {
+                           {kDrawModeParameter,
+                            {static_cast<uint32_t>(DrawMode::DRAW_ARRAYS),
+                             static_cast<uint32_t>(DrawMode::DRAW_INLINE_BUFFERS),
+                             static_cast<uint32_t>(DrawMode::DRAW_INLINE_ARRAYS),
+                             static_cast<uint32_t>(DrawMode::DRAW_INLINE_ELEMENTS)},
+                            DrawModeLabel},
+                           {kVertexShaderParameter, {0, 1}, VertexShaderLabel},
+                           {kDrawsParameter, {}, nullptr, 1, kMaxTunableWorkload},
+                       },
+                       [this](const std::string &name, const ParameterValues &parameters) {
+                         Test(name, static_cast<DrawMode>(parameters.at(kDrawModeParameter)),
+                              parameters.at(kVertexShaderParameter) != 0, parameters);
+                       });
+  SupportTunables({Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION});
 }
 
 /**
@@ -119,10 +126,13 @@ void TinyDrawTests::Initialize() {
 
 void TinyDrawTests::Deinitialize() {
   host_.ClearVertexBuffer();
+  vertex_buffer_.reset();
+  index_buffer_.clear();
   TestSuite::Deinitialize();
 }
 
-void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool use_vsh) {
+void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool use_vsh,
+                         const ParameterValues &parameters) {
   host_.PrepareDraw(0xFF333333);
 
   if (use_vsh) {
@@ -134,10 +144,16 @@ void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool
   }
 
   TestHost::ProfileResults results{};
-  const uint32_t num_draws = host_.GetSaveResults() ? kNumDrawsSingleFrame : GetNumDrawsForMode(draw_mode);
+  // A swept draw count takes precedence in both single frame and continuous mode.
+  uint32_t num_draws = GetParameter(parameters, kDrawsParameter, 0);
+  if (!num_draws) {
+    num_draws = host_.GetSaveResults() ? GetTunable(Tunable::DRAWS_PER_ITERATION, kNumDrawsSingleFrame)
+                                       : ContinuousWorkload(GetNumDrawsForMode(draw_mode));
+  }
+  const uint32_t iterations = GetTunable(Tunable::ITERATIONS, kIterations);
   switch (draw_mode) {
     case DrawMode::DRAW_ARRAYS:
-      results = Profile(test_name, kIterations, [this, num_draws] {
+      results = Profile(test_name, iterations, [this, num_draws] {
         for (auto i = 0; i < num_draws; ++i) {
           host_.DrawArrays(kVertexAttributes, kPrimitive);
         }
@@ -145,7 +161,7 @@ void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool
       break;
 
     case DrawMode::DRAW_INLINE_BUFFERS:
-      results = Profile(test_name, kIterations, [this, num_draws] {
+      results = Profile(test_name, iterations, [this, num_draws] {
         for (auto i = 0; i < num_draws; ++i) {
           host_.DrawInlineBuffer(kVertexAttributes, kPrimitive);
         }
@@ -153,7 +169,7 @@ void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool
       break;
 
     case DrawMode::DRAW_INLINE_ELEMENTS:
-      results = Profile(test_name, kIterations, [this, num_draws] {
+      results = Profile(test_name, iterations, [this, num_draws] {
         for (auto i = 0; i < num_draws; ++i) {
           host_.DrawInlineElements16(index_buffer_, kVertexAttributes, kPrimitive);
         }
@@ -161,7 +177,7 @@ void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool
       break;
 
     case DrawMode::DRAW_INLINE_ARRAYS:
-      results = Profile(test_name, kIterations, [this, num_draws] {
+      results = Profile(test_name, iterations, [this, num_draws] {
         for (auto i = 0; i < num_draws; ++i) {
           host_.DrawInlineArray(kVertexAttributes, kPrimitive);
         }
@@ -169,5 +185,12 @@ void TinyDrawTests::Test(const std::string &test_name, DrawMode draw_mode, bool
       break;
   }
 
+  results.work_per_iteration = {
+      .draws = num_draws,
+      .vertices = num_draws * 3,
+      .primitives = num_draws,
+      .pixels = num_draws * kPixelsPerDraw,
+  };
+
   host_.FinishDraw(suite_name_, test_name, results);
 }
@@ -30,7 +30,7 @@ class TinyDrawTests : public TestSuite {
   void Deinitialize() override;
 
  private:
-  void Test(const std::string &test_name, DrawMode draw_mode, bool use_vsh);
+  void Test(const std::string &test_name, DrawMode draw_mode, bool use_vsh, const ParameterValues &parameters);
 
  private:
   std::shared_ptr<PBKitPlusPlus::VertexBuffer> vertex_buffer_;
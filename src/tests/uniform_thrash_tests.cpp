@@ -9,6 +9,11 @@ static constexpr char kTestName[] = "UniformThrash";
 static constexpr uint32_t kIterations = 10;
 static constexpr uint32_t kNumDrawsSingleFrame = 100;
 static constexpr uint32_t kNumDrawsMultiFrame = 830;
+// Quads are laid out in rows of this many, so fewer draws would not fill the width of the framebuffer.
+static constexpr uint32_t kQuadsPerRow = 10;
+static constexpr uint32_t kMinDraws = kQuadsPerRow;
+// Bounds the number of rows, beyond which quads would be less than a pixel tall.
+static constexpr uint32_t kMaxDraws = 3000;
 
 // clang-format off
 static const uint32_t kShader[] = {
@@ -19,6 +24,8 @@ static const uint32_t kShader[] = {
 UniformThrashTests::UniformThrashTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "UniformThrash", config) {
   tests_[kTestName] = [this]() { Test(); };
+  SupportTunables({Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION});
+  SetTunableRange(Tunable::DRAWS_PER_ITERATION, kMinDraws, kMaxDraws);
 }
 
 /**
@@ -76,13 +83,16 @@ void UniformThrashTests::Test() {
   TestHost::ProfileResults results{};
 
   static constexpr float kTopMargin = 96.f;
-  const float kQuadWidth = ceilf(host_.GetFramebufferWidthF() / 10.f);
-  const uint32_t num_draws = host_.GetSaveResults() ? kNumDrawsSingleFrame : kNumDrawsMultiFrame;
-  const float kQuadHeight = ceilf(host_.GetFramebufferHeightF() - kTopMargin) / (static_cast<float>(num_draws) / 10.f);
+  const float kQuadWidth = ceilf(host_.GetFramebufferWidthF() / static_cast<float>(kQuadsPerRow));
+  const uint32_t num_draws = host_.GetSaveResults() ? GetTunable(Tunable::DRAWS_PER_ITERATION, kNumDrawsSingleFrame)
+                                                     : ContinuousWorkload(kNumDrawsMultiFrame, kMinDraws, kMaxDraws);
+  const uint32_t num_rows = (num_draws + kQuadsPerRow - 1) / kQuadsPerRow;
+  const float kQuadHeight = ceilf(host_.GetFramebufferHeightF() - kTopMargin) / static_cast<float>(num_rows);
 
   static constexpr float kZ = 1.f;
 
-  results = Profile(kTestName, kIterations, [this, shader, kQuadWidth, kQuadHeight, num_draws] {
+  const uint32_t iterations = GetTunable(Tunable::ITERATIONS, kIterations);
+  results = Profile(kTestName, iterations, [this, shader, kQuadWidth, kQuadHeight, num_draws] {
     XboxMath::vector_t diffuse;
     for (auto i = 0; i < num_draws; ++i) {
       SetVertexColor(diffuse, i);
@@ -90,8 +100,8 @@ void UniformThrashTests::Test() {
       shader->PrepareDraw();
 
       host_.Begin(TestHost::PRIMITIVE_QUADS);
-      float left = static_cast<float>(i % 10) * kQuadWidth;
-      float top = kTopMargin + floorf(static_cast<float>(i) / 10.f) * kQuadHeight;
+      float left = static_cast<float>(i % kQuadsPerRow) * kQuadWidth;
+      float top = kTopMargin + static_cast<float>(i / kQuadsPerRow) * kQuadHeight;
       host_.SetVertex(left, top, kZ);
       host_.SetVertex(left + kQuadWidth, top, kZ);
       host_.SetVertex(left + kQuadWidth, top + kQuadHeight, kZ);
@@ -100,6 +110,13 @@ void UniformThrashTests::Test() {
     }
   });
 
+  results.work_per_iteration = {
+      .draws = num_draws,
+      .vertices = num_draws * 4,
+      .primitives = num_draws,
+      .pixels = static_cast<uint64_t>(static_cast<float>(num_draws) * kQuadWidth * kQuadHeight),
+  };
+
   host_.FinishDraw(suite_name_, kTestName, results);
 
   host_.SetVertexShaderProgram(nullptr);
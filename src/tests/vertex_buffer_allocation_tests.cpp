@@ -10,6 +10,10 @@ using namespace PBKitPlusPlus;
 static constexpr char kTinyAllocationTest[] = "TinyAlloc";
 static constexpr char kMixedVertexCountTest[] = "MixedVtxAlloc";
 
+static constexpr char kDrawModeParameter[] = "draw_mode";
+//! Number of draws per iteration of the TinyAlloc tests. Not swept by default.
+static constexpr char kDrawsParameter[] = "draws";
+
 static constexpr uint32_t kMixedVertexBufferSizeMultiframeArrays[] = {
     0x2a12, 0x17cdc, 0xb43,  0x1f5,  0x1522, 0x1a0,  0x1292, 0x123,
     0x3c,   0x1bde,  0x1b31, 0x1a2e, 0x1d00, 0x1FFE, 0x12a7, 0x9ef,
@@ -56,25 +60,23 @@ static constexpr uint32_t kArrayEntriesPerVertex = 15;
 
 static constexpr uint32_t kSmallestVertexBufferSize = kArrayEntriesPerVertex * 4;
 
-static std::string MakeTestName(const std::string &prefix, VertexBufferAllocationTests::DrawMode draw_mode) {
-  std::string ret = prefix;
+//! Returns the number of vertices created by CreateGeometry for the given number of array entries.
+static constexpr uint32_t GetVertexCount(uint32_t target_array_entries) {
+  return (target_array_entries / (4 * kArrayEntriesPerVertex)) * 4;
+}
 
-  switch (draw_mode) {
+static std::string DrawModeLabel(uint32_t draw_mode) {
+  switch (static_cast<VertexBufferAllocationTests::DrawMode>(draw_mode)) {
     case VertexBufferAllocationTests::DrawMode::DRAW_ARRAYS:
-      ret += "-arrays";
-      break;
+      return "arrays";
     case VertexBufferAllocationTests::DrawMode::DRAW_INLINE_BUFFERS:
-      ret += "-inlinebuffers";
-      break;
+      return "inlinebuffers";
     case VertexBufferAllocationTests::DrawMode::DRAW_INLINE_ARRAYS:
-      ret += "-inlinearrays";
-      break;
+      return "inlinearrays";
     case VertexBufferAllocationTests::DrawMode::DRAW_INLINE_ELEMENTS:
-      ret += "-inlineelements";
-      break;
+      return "inlineelements";
   }
-
-  return ret;
+  return "";
 }
 
 /**
@@ -108,14 +110,23 @@ static std::string MakeTestName(const std::string &prefix, VertexBufferAllocatio
  */
 VertexBufferAllocationTests::VertexBufferAllocationTests(TestHost &host, std::string output_dir, const Config &config)
     : TestSuite(host, std::move(output_dir), "Vertex buffer allocation", config) {
-  for (auto draw_mode : {DrawMode::DRAW_ARRAYS, DrawMode::DRAW_INLINE_BUFFERS, DrawMode::DRAW_INLINE_ARRAYS,
-                         DrawMode::DRAW_INLINE_ELEMENTS}) {
-    auto name = MakeTestName(kMixedVertexCountTest, draw_mode);
-    tests_[name] = [this, name, draw_mode]() { TestMixedSizes(name, draw_mode); };
-
-    name = MakeTestName(kTinyAllocationTest, draw_mode);
-    tests_[name] = [this, name, draw_mode]() { TestTinyAllocations(name, draw_mode); };
-  }
+  const ParameterAxis draw_mode_axis{kDrawModeParameter,
+                                     {static_cast<uint32_t>(DrawMode::DRAW_ARRAYS),
+                                      static_cast<uint32_t>(DrawMode::DRAW_INLINE_BUFFERS),
+                                      static_cast<uint32_t>(DrawMode::DRAW_INLINE_ARRAYS),
+                                      static_cast<uint32_t>(DrawMode::DRAW_INLINE_ELEMENTS)},
+                                     DrawModeLabel};
+
+  AddParameterizedTest(kMixedVertexCountTest, {draw_mode_axis},
+                       [this](const std::string &name, const ParameterValues &parameters) {
+                         TestMixedSizes(name, static_cast<DrawMode>(parameters.at(kDrawModeParameter)));
+                       });
+  AddParameterizedTest(kTinyAllocationTest, {draw_mode_axis, {kDrawsParameter, {}, nullptr, 1, kMaxTunableWorkload}},
+                       [this](const std::string &name, const ParameterValues &parameters) {
+                         TestTinyAllocations(name, static_cast<DrawMode>(parameters.at(kDrawModeParameter)),
+                                             parameters);
+                       });
+  SupportTunables({Tunable::ITERATIONS, Tunable::DRAWS_PER_ITERATION});
 }
 
 static void CreateGeometry(TestHost &host, std::vector<uint32_t> &index_buffer, uint32_t target_array_entries) {
@@ -231,12 +242,13 @@ void VertexBufferAllocationTests::TestMixedSizes(const std::string &name, DrawMo
   static constexpr auto kPrimitive = TestHost::PRIMITIVE_QUADS;
 
   TestHost::ProfileResults results{};
+  const uint32_t iterations = GetTunable(Tunable::ITERATIONS, kNumProfilingRuns);
   const auto vertex_counts =
       host_.GetSaveResults() ? kMixedVertexBufferSizesSingleFrame : GetMixedVertexBufferSizesMultiframe(draw_mode);
 
   switch (draw_mode) {
     case DrawMode::DRAW_ARRAYS:
-      results = Profile(name, kNumProfilingRuns, [this, vertex_counts] {
+      results = Profile(name, iterations, [this, vertex_counts] {
         for (auto idx = 0; idx < std::size(kMixedVertexBufferSizesSingleFrame); ++idx) {
           auto vertex_count = vertex_counts[idx];
           std::vector<uint32_t> index_buffer;
@@ -249,7 +261,7 @@ void VertexBufferAllocationTests::TestMixedSizes(const std::string &name, DrawMo
       break;
 
     case DrawMode::DRAW_INLINE_BUFFERS:
-      results = Profile(name, kNumProfilingRuns, [this, vertex_counts] {
+      results = Profile(name, iterations, [this, vertex_counts] {
         for (auto idx = 0; idx < std::size(kMixedVertexBufferSizesSingleFrame); ++idx) {
           auto vertex_count = vertex_counts[idx];
           std::vector<uint32_t> index_buffer;
@@ -262,7 +274,7 @@ void VertexBufferAllocationTests::TestMixedSizes(const std::string &name, DrawMo
       break;
 
     case DrawMode::DRAW_INLINE_ELEMENTS:
-      results = Profile(name, kNumProfilingRuns, [this, vertex_counts] {
+      results = Profile(name, iterations, [this, vertex_counts] {
         for (auto idx = 0; idx < std::size(kMixedVertexBufferSizesSingleFrame); ++idx) {
           auto vertex_count = vertex_counts[idx];
           std::vector<uint32_t> index_buffer;
@@ -275,7 +287,7 @@ void VertexBufferAllocationTests::TestMixedSizes(const std::string &name, DrawMo
       break;
 
     case DrawMode::DRAW_INLINE_ARRAYS:
-      results = Profile(name, kNumProfilingRuns, [this, vertex_counts] {
+      results = Profile(name, iterations, [this, vertex_counts] {
         for (auto idx = 0; idx < std::size(kMixedVertexBufferSizesSingleFrame); ++idx) {
           auto vertex_count = vertex_counts[idx];
           std::vector<uint32_t> index_buffer;
@@ -288,6 +300,16 @@ void VertexBufferAllocationTests::TestMixedSizes(const std::string &name, DrawMo
       break;
   }
 
+  uint64_t num_vertices = 0;
+  for (auto idx = 0; idx < std::size(kMixedVertexBufferSizesSingleFrame); ++idx) {
+    num_vertices += GetVertexCount(vertex_counts[idx]);
+  }
+  results.work_per_iteration = {
+      .draws = std::size(kMixedVertexBufferSizesSingleFrame),
+      .vertices = num_vertices,
+      .primitives = num_vertices / 4,
+  };
+
   host_.FinishDraw(suite_name_, name, results);
 }
 
@@ -303,7 +325,8 @@ static constexpr uint32_t GetTinyAllocDrawsMultiframe(VertexBufferAllocationTest
   return 0;
 }
 
-void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, DrawMode draw_mode) {
+void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, DrawMode draw_mode,
+                                                      const ParameterValues &parameters) {
   auto shader = std::make_shared<PassthroughVertexShader>();
   host_.SetVertexShaderProgram(shader);
 
@@ -315,10 +338,16 @@ void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, D
   static constexpr auto kPrimitive = TestHost::PRIMITIVE_QUADS;
 
   TestHost::ProfileResults results{};
-  const uint32_t num_draws = host_.GetSaveResults() ? kNumDrawsSingleFrame : GetTinyAllocDrawsMultiframe(draw_mode);
+  const uint32_t iterations = GetTunable(Tunable::ITERATIONS, kNumProfilingRuns);
+  // A swept draw count takes precedence in both single frame and continuous mode.
+  uint32_t num_draws = GetParameter(parameters, kDrawsParameter, 0);
+  if (!num_draws) {
+    num_draws = host_.GetSaveResults() ? GetTunable(Tunable::DRAWS_PER_ITERATION, kNumDrawsSingleFrame)
+                                       : ContinuousWorkload(GetTinyAllocDrawsMultiframe(draw_mode));
+  }
   switch (draw_mode) {
     case DrawMode::DRAW_ARRAYS:
-      results = Profile(name, kNumProfilingRuns, [this, num_draws] {
+      results = Profile(name, iterations, [this, num_draws] {
         std::vector<uint32_t> index_buffer;
         for (auto i = 0; i < num_draws; ++i) {
           CreateGeometry(host_, index_buffer, kSmallestVertexBufferSize);
@@ -330,7 +359,7 @@ void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, D
       break;
 
     case DrawMode::DRAW_INLINE_BUFFERS:
-      results = Profile(name, kNumProfilingRuns, [this, num_draws] {
+      results = Profile(name, iterations, [this, num_draws] {
         std::vector<uint32_t> index_buffer;
         for (auto i = 0; i < num_draws; ++i) {
           CreateGeometry(host_, index_buffer, kSmallestVertexBufferSize);
@@ -342,7 +371,7 @@ void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, D
       break;
 
     case DrawMode::DRAW_INLINE_ELEMENTS:
-      results = Profile(name, kNumProfilingRuns, [this, num_draws] {
+      results = Profile(name, iterations, [this, num_draws] {
         std::vector<uint32_t> index_buffer;
         for (auto i = 0; i < num_draws; ++i) {
           CreateGeometry(host_, index_buffer, kSmallestVertexBufferSize);
@@ -354,7 +383,7 @@ void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, D
       break;
 
     case DrawMode::DRAW_INLINE_ARRAYS:
-      results = Profile(name, kNumProfilingRuns, [this, num_draws] {
+      results = Profile(name, iterations, [this, num_draws] {
         std::vector<uint32_t> index_buffer;
         for (auto i = 0; i < num_draws; ++i) {
           CreateGeometry(host_, index_buffer, kSmallestVertexBufferSize);
@@ -366,5 +395,11 @@ void VertexBufferAllocationTests::TestTinyAllocations(const std::string &name, D
       break;
   }
 
+  results.work_per_iteration = {
+      .draws = num_draws,
+      .vertices = num_draws * GetVertexCount(kSmallestVertexBufferSize),
+      .primitives = num_draws,
+  };
+
   host_.FinishDraw(suite_name_, name, results);
 }
@@ -32,7 +32,7 @@ class VertexBufferAllocationTests : public TestSuite {
   void Deinitialize() override;
 
  private:
-  void TestTinyAllocations(const std::string &name, DrawMode mode);
+  void TestTinyAllocations(const std::string &name, DrawMode mode, const ParameterValues &parameters);
   void TestMixedSizes(const std::string &name, DrawMode mode);
 };
 
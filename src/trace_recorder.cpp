@@ -0,0 +1,148 @@
+#include "trace_recorder.h"
+
+#include "debug_output.h"
+#include "json_writer.h"
+#include "test_host.h"
+
+// Every event is attributed to a single process and thread, as tests execute sequentially.
+static constexpr uint32_t kTraceProcessId = 1;
+static constexpr uint32_t kTraceThreadId = 1;
+
+TraceRecorder *TraceRecorder::singleton_ = nullptr;
+
+TraceRecorder::Scope::Scope(const char *category, const char *name) : category_(category) {
+  if (IsEnabled()) {
+    name_id_ = InternName(name);
+    start_ticks_ = Now();
+  }
+}
+
+TraceRecorder::Scope::Scope(const char *category, const std::string &name) : category_(category) {
+  if (IsEnabled()) {
+    name_id_ = InternName(name);
+    start_ticks_ = Now();
+  }
+}
+
+TraceRecorder::Scope::~Scope() {
+  if (IsEnabled()) {
+    AddEvent(category_, name_id_, start_ticks_, Now() - start_ticks_);
+  }
+}
+
+TraceRecorder::TraceRecorder(const std::string &trace_path, const TestHost &host, bool in_memory)
+    : host_(host), in_memory_(in_memory) {
+  PrintMsg("Opening trace file at %s\n", trace_path.c_str());
+  trace_file_.open(trace_path, std::ios_base::trunc);
+  ASSERT(trace_file_ && "Failed to open trace file for output");
+
+  JsonWriter process_name;
+  process_name.BeginObject();
+  process_name.Add("name", "process_name");
+  process_name.Add("ph", "M");
+  process_name.Add("pid", kTraceProcessId);
+  process_name.Add("tid", kTraceThreadId);
+  process_name.BeginObject("args");
+  process_name.Add("name", "xemu-perf-tests");
+  process_name.EndObject();
+  process_name.EndObject();
+
+  // Records the clock so that the guest timeline can be aligned with other traces of the same run.
+  JsonWriter clock;
+  clock.BeginObject();
+  clock.Add("name", "trace_start");
+  clock.Add("cat", "run");
+  clock.Add("ph", "i");
+  clock.Add("s", "g");
+  clock.Add("ts", static_cast<double>(host.ReadTimer()) * 1000000.0 / static_cast<double>(host.GetTimerFrequency()));
+  clock.Add("pid", kTraceProcessId);
+  clock.Add("tid", kTraceThreadId);
+  clock.BeginObject("args");
+  clock.Add("timer_source", TestHost::TimerSourceName(host.GetTimerSource()));
+  clock.Add("timer_frequency", host.GetTimerFrequency());
+  clock.EndObject();
+  clock.EndObject();
+
+  trace_file_ << "[\n" << process_name.str() << ",\n" << clock.str() << ",\n";
+  trace_file_.flush();
+}
+
+void TraceRecorder::Initialize(const std::string &trace_path, const TestHost &host, bool in_memory) {
+  ASSERT(!singleton_ && "Invalid attempt to initialize trace recorder twice.");
+
+  singleton_ = new TraceRecorder(trace_path, host, in_memory);
+}
+
+uint64_t TraceRecorder::Now() {
+  ASSERT(singleton_ && "Attempt to use TraceRecorder before Initialize");
+  return singleton_->host_.ReadTimer();
+}
+
+uint32_t TraceRecorder::InternName(const std::string &name) {
+  ASSERT(singleton_ && "Attempt to use TraceRecorder before Initialize");
+  auto it = singleton_->name_ids_.find(name);
+  if (it != singleton_->name_ids_.end()) {
+    return it->second;
+  }
+
+  const auto id = static_cast<uint32_t>(singleton_->names_.size());
+  singleton_->names_.push_back(name);
+  singleton_->name_ids_[name] = id;
+  return id;
+}
+
+void TraceRecorder::AddEvent(const char *category, uint32_t name_id, uint64_t start_ticks, uint64_t duration_ticks,
+                             int32_t iteration) {
+  if (!singleton_) {
+    return;
+  }
+  singleton_->events_.push_back({category, name_id, start_ticks, duration_ticks, iteration});
+}
+
+void TraceRecorder::Flush() {
+  if (!singleton_ || singleton_->in_memory_) {
+    return;
+  }
+  singleton_->WriteEvents();
+}
+
+void TraceRecorder::Close() {
+  if (!singleton_) {
+    return;
+  }
+
+  singleton_->WriteEvents();
+  singleton_->trace_file_.close();
+  delete singleton_;
+  singleton_ = nullptr;
+}
+
+void TraceRecorder::WriteEvents() {
+  if (events_.empty()) {
+    return;
+  }
+
+  const double microseconds_per_tick = 1000000.0 / static_cast<double>(host_.GetTimerFrequency());
+  for (const auto &event : events_) {
+    JsonWriter record;
+    record.BeginObject();
+    record.Add("name", names_[event.name_id]);
+    record.Add("cat", event.category);
+    record.Add("ph", "X");
+    record.Add("ts", static_cast<double>(event.start_ticks) * microseconds_per_tick);
+    record.Add("dur", static_cast<double>(event.duration_ticks) * microseconds_per_tick);
+    record.Add("pid", kTraceProcessId);
+    record.Add("tid", kTraceThreadId);
+    if (event.iteration >= 0) {
+      record.BeginObject("args");
+      record.Add("iteration", event.iteration);
+      record.EndObject();
+    }
+    record.EndObject();
+    trace_file_ << record.str() << ",\n";
+  }
+  trace_file_.flush();
+  ASSERT(trace_file_ && "Failed to write trace file");
+
+  events_.clear();
+}
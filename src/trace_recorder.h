@@ -0,0 +1,96 @@
+#ifndef XEMU_PERF_TESTS_TRACE_RECORDER_H
+#define XEMU_PERF_TESTS_TRACE_RECORDER_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+class TestHost;
+
+/**
+ * Records a timeline of the run as Chrome trace events, viewable in Perfetto (https://ui.perfetto.dev) or
+ * chrome://tracing.
+ *
+ * Events are timestamped with the TestHost profiling timer, the same clock used for the raw samples in the results, so
+ * that an event's duration matches the corresponding sample exactly. Timestamps are the time since the timer started
+ * counting (i.e., since boot), in microseconds.
+ *
+ * Like Logger, events are accumulated in memory and only written to disk when Flush or Close is called. The file uses
+ * the JSON array format, which viewers accept without the closing bracket, so the trace of a run that did not
+ * complete remains usable.
+ */
+class TraceRecorder {
+ public:
+  //! Records a complete event covering the lifetime of the scope. Does nothing if tracing is disabled.
+  class Scope {
+   public:
+    Scope(const char *category, const char *name);
+    Scope(const char *category, const std::string &name);
+    ~Scope();
+
+   private:
+    const char *category_;
+    uint32_t name_id_{0};
+    uint64_t start_ticks_{0};
+  };
+
+ public:
+  /**
+   * Opens the trace file at the given path, discarding any existing content.
+   * @param trace_path - The path to the trace file.
+   * @param host - The TestHost whose profiling timer is used to timestamp events.
+   * @param in_memory - If true, Flush is ignored and all events are held in memory until Close.
+   */
+  static void Initialize(const std::string &trace_path, const TestHost &host, bool in_memory = false);
+
+  [[nodiscard]] static bool IsEnabled() { return singleton_ != nullptr; }
+
+  //! Returns the current value of the profiling timer.
+  static uint64_t Now();
+
+  //! Returns an identifier for the given event name. Timing sensitive code should intern names ahead of time.
+  static uint32_t InternName(const std::string &name);
+
+  /**
+   * Records a complete event. Does nothing if tracing is disabled.
+   * @param category - Event category, must be a string literal.
+   * @param name_id - Name of the event, as returned by InternName.
+   * @param start_ticks - Profiling timer value at the start of the event.
+   * @param duration_ticks - Duration of the event in profiling timer ticks.
+   * @param iteration - Index of the profiled iteration represented by the event, or -1.
+   */
+  static void AddEvent(const char *category, uint32_t name_id, uint64_t start_ticks, uint64_t duration_ticks,
+                       int32_t iteration = -1);
+
+  //! Writes any buffered events to disk. Does nothing in in-memory mode.
+  static void Flush();
+
+  //! Writes any buffered events to disk and closes the trace file.
+  static void Close();
+
+ private:
+  struct Event {
+    const char *category;
+    uint32_t name_id;
+    uint64_t start_ticks;
+    uint64_t duration_ticks;
+    int32_t iteration;
+  };
+
+  TraceRecorder(const std::string &trace_path, const TestHost &host, bool in_memory);
+
+  void WriteEvents();
+
+  const TestHost &host_;
+  bool in_memory_;
+  std::ofstream trace_file_;
+  std::vector<Event> events_;
+  std::vector<std::string> names_;
+  std::map<std::string, uint32_t> name_ids_;
+
+  static TraceRecorder *singleton_;
+};
+
+#endif  // XEMU_PERF_TESTS_TRACE_RECORDER_H
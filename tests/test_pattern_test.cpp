@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "test_pattern.h"
+
+static int failures = 0;
+
+#define EXPECT(condition)                                                            \
+  do {                                                                               \
+    if (!(condition)) {                                                              \
+      fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #condition); \
+      ++failures;                                                                    \
+    }                                                                                \
+  } while (0)
+
+//! Returns true if the given pattern parses and matches the given name.
+static bool Matches(const std::string &pattern, const std::string &name) {
+  TestPattern test_pattern;
+  std::string error;
+  if (!test_pattern.Parse(pattern, error)) {
+    fprintf(stderr, "Failed to parse '%s': %s\n", pattern.c_str(), error.c_str());
+    ++failures;
+    return false;
+  }
+  return test_pattern.Matches(name);
+}
+
+//! Returns true if the given pattern is rejected.
+static bool Rejects(const std::string &pattern) {
+  TestPattern test_pattern;
+  std::string error;
+  if (test_pattern.Parse(pattern, error)) {
+    return false;
+  }
+  return !error.empty();
+}
+
+static void TestGlob() {
+  EXPECT(Matches("FillRate::*", "FillRate::Fill-640x480"));
+  EXPECT(!Matches("FillRate::*", "TinyDraw::FillRate::x"));
+  EXPECT(Matches("*", ""));
+  EXPECT(Matches("Draw?", "Draw1"));
+  EXPECT(!Matches("Draw?", "Draw"));
+  EXPECT(!Matches("Draw?", "Draw12"));
+  EXPECT(Matches("Draw[0-9]", "Draw7"));
+  EXPECT(!Matches("Draw[!0-9]", "Draw7"));
+  EXPECT(Matches("Draw[^0-9]", "DrawX"));
+  EXPECT(Matches("[]]", "]"));
+  // Globs have no special characters beyond `*`, `?`, and `[`.
+  EXPECT(Matches("a.b(c)", "a.b(c)"));
+  EXPECT(!Matches("a.b", "axb"));
+  EXPECT(Matches("*::*-draws1000", "TinyDraw::Quads-draws1000"));
+  EXPECT(!Matches("*::*-draws1000", "TinyDraw::Quads-draws10000"));
+  EXPECT(Rejects("Draw[0-9"));
+  EXPECT(Rejects("Draw[9-0]"));
+}
+
+static void TestRegex() {
+  // Regular expressions match anywhere in the name unless anchored.
+  EXPECT(Matches("re:draws\\d+", "TinyDraw::Quads-draws1000"));
+  EXPECT(!Matches("re:^draws", "TinyDraw::Quads-draws1000"));
+  EXPECT(Matches("re:^TinyDraw::", "TinyDraw::Quads"));
+  EXPECT(Matches("re:Quads$", "TinyDraw::Quads"));
+  EXPECT(!Matches("re:Quads$", "TinyDraw::QuadsX"));
+  EXPECT(Matches("re:", "anything"));
+
+  EXPECT(Matches("re:^(Fill|Tiny)", "TinyDraw::Quads"));
+  EXPECT(Matches("re:^(?:Fill|Tiny)Draw", "TinyDraw::Quads"));
+  EXPECT(!Matches("re:^(Fill|Tiny)Rate", "TinyDraw::Quads"));
+  EXPECT(Matches("re:a|b", "xbx"));
+
+  EXPECT(Matches("re:^ab*c$", "ac"));
+  EXPECT(Matches("re:^ab*c$", "abbbc"));
+  EXPECT(!Matches("re:^ab+c$", "ac"));
+  EXPECT(Matches("re:^ab?c$", "abc"));
+  EXPECT(!Matches("re:^ab?c$", "abbc"));
+  EXPECT(Matches("re:^a.*?c$", "abbc"));
+  EXPECT(Matches("re:^(ab)+$", "ababab"));
+  EXPECT(!Matches("re:^(ab)+$", "ababa"));
+
+  EXPECT(Matches("re:^[a-c]+$", "abcab"));
+  EXPECT(!Matches("re:^[^a-c]+$", "xxa"));
+  EXPECT(Matches("re:^[\\d_]+$", "1_2"));
+  EXPECT(Matches("re:^\\w+$", "Quads_1"));
+  EXPECT(!Matches("re:^\\w+$", "Quads-1"));
+  EXPECT(Matches("re:^\\D+$", "Quads"));
+  EXPECT(Matches("re:\\s", "a b"));
+  EXPECT(Matches("re:^a\\.b$", "a.b"));
+  EXPECT(!Matches("re:^a\\.b$", "axb"));
+  EXPECT(Matches("re:^\\(x\\)$", "(x)"));
+}
+
+static void TestRegexErrors() {
+  EXPECT(Rejects("re:(ab"));
+  EXPECT(Rejects("re:ab)"));
+  EXPECT(Rejects("re:[ab"));
+  EXPECT(Rejects("re:*a"));
+  EXPECT(Rejects("re:a**"));
+  EXPECT(Rejects("re:a{2}"));
+  EXPECT(Rejects("re:^*"));
+  EXPECT(Rejects("re:a\\"));
+  EXPECT(Rejects("re:\\q"));
+
+  // Repeated groups that may match an empty string are rejected, as they backtrack exponentially.
+  EXPECT(Rejects("re:(a*)*b"));
+  EXPECT(Rejects("re:(a|b?)+"));
+  EXPECT(Rejects("re:(^)*"));
+  EXPECT(Rejects("re:((a*))+"));
+  EXPECT(!Rejects("re:(a*)?b"));
+  EXPECT(!Rejects("re:(a+b*)*"));
+}
+
+static void TestBacktrackingIsBounded() {
+  TestPattern pattern;
+  std::string error;
+  EXPECT(pattern.Parse("re:^(a|a)*b", error));
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT(!pattern.Matches(std::string(26, 'a')));
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT(pattern.ExceededStepLimit());
+  EXPECT(elapsed < std::chrono::seconds(5));
+
+  EXPECT(pattern.Matches("aab"));
+  EXPECT(!pattern.ExceededStepLimit());
+}
+
+int main() {
+  TestGlob();
+  TestRegex();
+  TestRegexErrors();
+  TestBacktrackingIsBounded();
+
+  if (failures) {
+    fprintf(stderr, "%d expectation(s) failed\n", failures);
+    return 1;
+  }
+  printf("All TestPattern tests passed\n");
+  return 0;
+}
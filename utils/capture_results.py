@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+
+# ruff: noqa: T201 `print` found
+
+"""Captures results streamed by xemu-perf-tests (see the `stream_results` setting) and reassembles them in real time.
+
+Frames are read from a TCP socket (e.g., xemu's serial port exposed via `-serial tcp::4444,server,nowait`), a file or
+named pipe, or stdin. Each complete, checksum verified record is appended to the output file as soon as it arrives.
+
+The `frame` command performs the console side of the protocol on the host, converting an existing results file into a
+stream of frames. This allows the capture pipeline to be exercised without a console, e.g.:
+  capture_results.py frame results.ndjson | capture_results.py capture - -o captured.ndjson
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import socket
+import sys
+import time
+import zlib
+from typing import Iterator, TextIO
+
+FRAME_MAGIC = "@XPT1"
+MAX_CHUNK_SIZE = 200
+
+
+def encode_frames(record: str, sequence: int) -> list[str]:
+    """Returns the frames for the given single line record. Mirrors ResultStream::Send in src/result_stream.cpp."""
+    crc = zlib.crc32(record.encode("utf-8")) & 0xFFFFFFFF
+    data = record.encode("utf-8")
+    chunks = [data[i : i + MAX_CHUNK_SIZE] for i in range(0, len(data), MAX_CHUNK_SIZE)] or [b""]
+    return [
+        f"{FRAME_MAGIC} {sequence} {index} {len(chunks)} {crc:08x} {chunk.decode('utf-8', errors='surrogateescape')}"
+        for index, chunk in enumerate(chunks)
+    ]
+
+
+class Reassembler:
+    """Collects frames and yields complete records."""
+
+    def __init__(self):
+        self._pending: dict[int, dict[int, str]] = {}
+        self.discarded = 0
+
+    def add_line(self, line: str) -> str | None:
+        """Processes one line of input, returning a record if it completes one."""
+        start = line.find(FRAME_MAGIC + " ")
+        if start < 0:
+            return None
+
+        fields = line[start:].rstrip("\r\n").split(" ", 5)
+        if len(fields) < 5:
+            self.discarded += 1
+            return None
+        try:
+            sequence = int(fields[1])
+            index = int(fields[2])
+            count = int(fields[3])
+            crc = int(fields[4], 16)
+        except ValueError:
+            self.discarded += 1
+            return None
+        chunk = fields[5] if len(fields) > 5 else ""
+
+        # A new run restarts the sequence, dropping anything left over from a run that was interrupted.
+        if sequence == 0 and index == 0 and self._pending:
+            self.discarded += len(self._pending)
+            self._pending.clear()
+
+        chunks = self._pending.setdefault(sequence, {})
+        chunks[index] = chunk
+        if len(chunks) < count:
+            return None
+
+        del self._pending[sequence]
+        record = "".join(chunks[i] for i in range(count) if i in chunks)
+        if len(chunks) != count or zlib.crc32(record.encode("utf-8", errors="surrogateescape")) & 0xFFFFFFFF != crc:
+            print(f"Discarding record {sequence}: checksum mismatch", file=sys.stderr)
+            self.discarded += 1
+            return None
+        return record
+
+
+def read_socket_lines(address: str) -> Iterator[str]:
+    host, _, port = address.rpartition(":")
+    with socket.create_connection((host or "127.0.0.1", int(port))) as connection:
+        print(f"Connected to {address}", file=sys.stderr)
+        buffer = b""
+        while True:
+            data = connection.recv(4096)
+            if not data:
+                break
+            buffer += data
+            *lines, buffer = buffer.split(b"\n")
+            for line in lines:
+                yield line.decode("utf-8", errors="surrogateescape")
+
+
+def read_file_lines(stream: TextIO, *, follow: bool) -> Iterator[str]:
+    while True:
+        line = stream.readline()
+        if line:
+            yield line
+            continue
+        if not follow:
+            return
+        time.sleep(0.1)
+
+
+def describe(record: dict) -> str:
+    record_type = record.get("type", "?")
+    if record_type == "test_result":
+        median = record.get("median_ns")
+        median_text = f"{median / 1000000.0:.3f} ms" if isinstance(median, (int, float)) else "-"
+        return f"{record.get('name')}: median {median_text} over {record.get('iterations')} iterations"
+    if record_type == "run_header":
+        return f"Run started (revision {record.get('git_revision')})"
+    if record_type == "run_footer":
+        return "Run completed"
+    return record_type
+
+
+def capture(args) -> int:
+    if args.tcp:
+        lines = read_socket_lines(args.tcp)
+    elif args.input == "-":
+        lines = read_file_lines(sys.stdin, follow=False)
+    else:
+        lines = read_file_lines(open(args.input, errors="surrogateescape"), follow=args.follow)  # noqa: SIM115
+
+    reassembler = Reassembler()
+    output = open(args.output, "a", errors="surrogateescape") if args.output else sys.stdout  # noqa: SIM115
+    try:
+        for line in lines:
+            record = reassembler.add_line(line)
+            if record is None:
+                continue
+
+            output.write(record + "\n")
+            output.flush()
+            try:
+                parsed = json.loads(record)
+            except json.JSONDecodeError:
+                print("Received a record that is not valid JSON", file=sys.stderr)
+                continue
+
+            print(describe(parsed), file=sys.stderr)
+            if args.exit_on_footer and parsed.get("type") == "run_footer":
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if output is not sys.stdout:
+            output.close()
+
+    if reassembler.discarded:
+        print(f"{reassembler.discarded} record(s) were incomplete or corrupt", file=sys.stderr)
+        return 1
+    return 0
+
+
+def frame(args) -> int:
+    with open(args.results) as infile:
+        sequence = 0
+        for line in infile:
+            record = line.rstrip("\n")
+            if not record:
+                continue
+            for framed in encode_frames(record, sequence):
+                print(framed)
+            sequence += 1
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Capture results streamed from xemu-perf-tests.")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    capture_parser = subparsers.add_parser("capture", help="Reassemble streamed results.")
+    capture_parser.add_argument(
+        "input", nargs="?", default="-", help="File or named pipe to read frames from, or '-' for stdin."
+    )
+    capture_parser.add_argument("--tcp", metavar="HOST:PORT", help="Read frames from the given TCP socket instead.")
+    capture_parser.add_argument(
+        "--follow", action="store_true", help="Keep waiting for new data at the end of the input file."
+    )
+    capture_parser.add_argument("-o", "--output", help="File to which records are appended. Default: stdout.")
+    capture_parser.add_argument(
+        "--exit-on-footer", action="store_true", help="Stop capturing once a run_footer record is received."
+    )
+    capture_parser.set_defaults(handler=capture)
+
+    frame_parser = subparsers.add_parser("frame", help="Convert a results file into a stream of frames.")
+    frame_parser.add_argument("results", help="Results file to frame.")
+    frame_parser.set_defaults(handler=frame)
+
+    args = parser.parse_args()
+    sys.exit(args.handler(args))
+
+
+if __name__ == "__main__":
+    main()
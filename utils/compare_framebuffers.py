@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+
+# ruff: noqa: T201 `print` found
+
+"""Compares the framebuffers captured by xemu-perf-tests (see the `capture_framebuffers` setting) to golden images.
+
+A test whose capture differs from its golden image did not render what it was expected to, so its timing cannot be
+trusted. Such results are reported as invalid and, if `--output` is given, a copy of the results is written in which
+every test_result with a capture is annotated with `"framebuffer_valid": true|false`. compare_results.py and
+generate_report.py treat results annotated as invalid accordingly.
+
+Golden images are stored using the same relative paths as the captures, e.g., `<golden>/BusyPfifo/PFIFOSaturation.png`
+and may be created from a known good run via `--update-golden`.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import shutil
+import sys
+from dataclasses import dataclass
+
+from PIL import Image, ImageChops
+from results_loader import load_results
+
+
+@dataclass
+class ImageComparison:
+    name: str
+    capture: str
+    #: One of "match", "MISMATCH", "missing capture", or "no golden".
+    status: str
+    differing_pixels: int = 0
+    total_pixels: int = 0
+    max_difference: int = 0
+
+    @property
+    def differing_percent(self) -> float:
+        return self.differing_pixels * 100.0 / self.total_pixels if self.total_pixels else 0.0
+
+
+def compare_image(capture_path: str, golden_path: str, tolerance: int) -> tuple[int, int, int]:
+    """Returns (differing pixels, total pixels, maximum channel difference) between the given images."""
+    with Image.open(capture_path) as capture, Image.open(golden_path) as golden:
+        capture_rgb = capture.convert("RGB")
+        golden_rgb = golden.convert("RGB")
+
+    total = capture_rgb.width * capture_rgb.height
+    if capture_rgb.size != golden_rgb.size:
+        return total, total, 255
+
+    # Reduce the per-channel absolute difference to the largest channel difference of each pixel.
+    difference = ImageChops.difference(capture_rgb, golden_rgb)
+    channels = difference.split()
+    per_pixel = ImageChops.lighter(ImageChops.lighter(channels[0], channels[1]), channels[2])
+    histogram = per_pixel.histogram()
+    differing = sum(histogram[tolerance + 1 :])
+    max_difference = max((value for value, count in enumerate(histogram) if count), default=0)
+    return differing, total, max_difference
+
+
+def compare(records: list[dict], captures_dir: str, golden_dir: str, args) -> list[ImageComparison]:
+    ret = []
+    for record in records:
+        if record.get("type") != "test_result" or "framebuffer_capture" not in record:
+            continue
+
+        relative_path = record["framebuffer_capture"]
+        capture_path = os.path.join(captures_dir, *relative_path.split("/"))
+        golden_path = os.path.join(golden_dir, *relative_path.split("/"))
+        comparison = ImageComparison(name=record["name"], capture=relative_path, status="match")
+
+        if not os.path.isfile(capture_path):
+            comparison.status = "missing capture"
+        elif args.update_golden:
+            os.makedirs(os.path.dirname(golden_path), exist_ok=True)
+            shutil.copyfile(capture_path, golden_path)
+            comparison.status = "updated"
+        elif not os.path.isfile(golden_path):
+            comparison.status = "no golden"
+        else:
+            comparison.differing_pixels, comparison.total_pixels, comparison.max_difference = compare_image(
+                capture_path, golden_path, args.tolerance
+            )
+            if comparison.differing_percent > args.max_differing_percent:
+                comparison.status = "MISMATCH"
+
+        ret.append(comparison)
+    return ret
+
+
+def is_invalid(comparison: ImageComparison, *, strict: bool) -> bool:
+    if comparison.status in {"MISMATCH", "missing capture"}:
+        return True
+    return strict and comparison.status == "no golden"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare captured framebuffers against golden images.")
+    parser.add_argument("results", help="Results file of the run that captured the framebuffers.")
+    parser.add_argument("--golden", required=True, help="Directory containing the golden images.")
+    parser.add_argument(
+        "--captures", help="Directory containing the captured images. Default: the directory of the results file."
+    )
+    parser.add_argument(
+        "--tolerance",
+        type=int,
+        default=2,
+        help="Maximum per-channel difference for two pixels to be considered equal. Default: %(default)s",
+    )
+    parser.add_argument(
+        "--max-differing-percent",
+        type=float,
+        default=0.0,
+        help="Percentage of pixels that may exceed the tolerance before a capture is a mismatch. Default: %(default)s",
+    )
+    parser.add_argument("--strict", action="store_true", help="Treat captures without a golden image as invalid.")
+    parser.add_argument(
+        "--update-golden", action="store_true", help="Copy the captures into the golden directory instead of comparing."
+    )
+    parser.add_argument("-o", "--output", help="Path at which annotated results should be written.")
+    args = parser.parse_args()
+
+    captures_dir = args.captures or os.path.dirname(os.path.abspath(args.results))
+    results = load_results(args.results)
+    comparisons = compare(results.records, captures_dir, args.golden, args)
+    if not comparisons:
+        print("No framebuffer captures found, was the run made with capture_framebuffers enabled?", file=sys.stderr)
+        sys.exit(1)
+
+    name_width = max(len("Test"), *(len(row.name) for row in comparisons))
+    print(f"{'Test':<{name_width}}  {'Differing':>10}  {'Max diff':>8}  Status")
+    for row in comparisons:
+        differing = f"{row.differing_percent:.3f}%" if row.total_pixels else "-"
+        max_difference = str(row.max_difference) if row.total_pixels else "-"
+        print(f"{row.name:<{name_width}}  {differing:>10}  {max_difference:>8}  {row.status}")
+
+    if args.update_golden:
+        print(f"Updated {sum(1 for row in comparisons if row.status == 'updated')} golden image(s) in {args.golden}")
+        sys.exit(0)
+
+    invalid = {row.name for row in comparisons if is_invalid(row, strict=args.strict)}
+    print(f"{len(comparisons)} compared, {len(invalid)} invalid result(s)")
+
+    if args.output:
+        captured = {row.name for row in comparisons}
+        with open(args.output, "w") as outfile:
+            for record in results.records:
+                if record.get("type") == "test_result" and record.get("name") in captured:
+                    record["framebuffer_valid"] = record["name"] not in invalid
+                outfile.write(json.dumps(record) + "\n")
+
+    sys.exit(1 if invalid else 0)
+
+
+if __name__ == "__main__":
+    main()
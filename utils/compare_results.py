@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+
+# ruff: noqa: T201 `print` found
+
+"""Compares the per-iteration samples of two or more xemu-perf-tests result files.
+
+Each candidate is compared against the baseline test by test. A change is reported as significant when the statistical
+test rejects the hypothesis that both sets of samples come from the same distribution and the change in median exceeds
+the noise threshold. Tests whose framebuffer capture was annotated as not matching its golden image by
+compare_framebuffers.py are reported as invalid. The exit code is 1 if any candidate contains a significant regression
+or an invalid result, or if no test could be compared against the baseline.
+"""
+
+from __future__ import annotations
+
+import argparse
+import math
+import random
+import statistics
+import sys
+from dataclasses import dataclass
+
+from results_loader import RunResults, get_samples_ns, load_results
+
+# Minimum number of samples in each set for the normal approximation of the Mann-Whitney U statistic to be usable.
+MIN_SAMPLES = 5
+
+
+@dataclass
+class Comparison:
+    name: str
+    baseline_median_ns: float
+    candidate_median_ns: float
+    #: Change of the median as a percentage of the baseline median. Positive values are slower.
+    change_percent: float
+    #: Probability of superiority, i.e., P(candidate sample > baseline sample). 0.5 indicates no effect,
+    #: 1.0 indicates that every candidate sample is slower than every baseline sample.
+    effect_size: float
+    p_value: float | None
+    #: Bounds of the confidence interval of change_percent, if computed via bootstrap.
+    ci_low_percent: float | None = None
+    ci_high_percent: float | None = None
+    verdict: str = ""
+
+
+def mann_whitney_u(baseline: list[float], candidate: list[float]) -> tuple[float, float]:
+    """Returns (probability of superiority, two sided p-value) using the tie corrected normal approximation."""
+    n1 = len(baseline)
+    n2 = len(candidate)
+    combined = sorted([(value, 0) for value in baseline] + [(value, 1) for value in candidate])
+
+    # Assign average ranks to ties.
+    rank_sum_candidate = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < len(combined):
+        j = i
+        while j + 1 < len(combined) and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1.0
+        tied = j - i + 1
+        tie_term += tied**3 - tied
+        rank_sum_candidate += rank * sum(1 for k in range(i, j + 1) if combined[k][1])
+        i = j + 1
+
+    u_candidate = rank_sum_candidate - n2 * (n2 + 1) / 2.0
+    effect_size = u_candidate / (n1 * n2)
+
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return effect_size, 1.0
+
+    mean = n1 * n2 / 2.0
+    # Continuity correction.
+    z = (abs(u_candidate - mean) - 0.5) / math.sqrt(variance)
+    p_value = math.erfc(max(z, 0.0) / math.sqrt(2.0))
+    return effect_size, p_value
+
+
+def bootstrap_change_ci(
+    baseline: list[float], candidate: list[float], iterations: int, confidence: float, rng: random.Random
+) -> tuple[float, float]:
+    """Returns the bootstrap confidence interval of the percentage change of the median."""
+    changes = []
+    for _ in range(iterations):
+        baseline_median = statistics.median(rng.choices(baseline, k=len(baseline)))
+        candidate_median = statistics.median(rng.choices(candidate, k=len(candidate)))
+        changes.append((candidate_median - baseline_median) * 100.0 / baseline_median)
+    changes.sort()
+    tail = (1.0 - confidence) / 2.0
+    low = changes[int(tail * (iterations - 1))]
+    high = changes[int(math.ceil((1.0 - tail) * (iterations - 1)))]
+    return low, high
+
+
+def is_valid(record: dict) -> bool:
+    """Returns False if the test did not render the expected image (see compare_framebuffers.py)."""
+    return record.get("framebuffer_valid", True)
+
+
+def compare(baseline: RunResults, candidate: RunResults, args) -> list[Comparison]:
+    ret = []
+    rng = random.Random(args.seed)
+
+    for name in sorted(set(baseline.tests) & set(candidate.tests)):
+        baseline_samples = get_samples_ns(baseline.tests[name])
+        candidate_samples = get_samples_ns(candidate.tests[name])
+        if len(baseline_samples) < MIN_SAMPLES or len(candidate_samples) < MIN_SAMPLES:
+            continue
+
+        baseline_median = statistics.median(baseline_samples)
+        candidate_median = statistics.median(candidate_samples)
+        if baseline_median <= 0:
+            continue
+        change = (candidate_median - baseline_median) * 100.0 / baseline_median
+
+        effect_size, p_value = mann_whitney_u(baseline_samples, candidate_samples)
+        comparison = Comparison(
+            name=name,
+            baseline_median_ns=baseline_median,
+            candidate_median_ns=candidate_median,
+            change_percent=change,
+            effect_size=effect_size,
+            p_value=p_value,
+        )
+
+        if not is_valid(baseline.tests[name]) or not is_valid(candidate.tests[name]):
+            comparison.verdict = "INVALID"
+            ret.append(comparison)
+            continue
+
+        if args.method == "bootstrap":
+            comparison.ci_low_percent, comparison.ci_high_percent = bootstrap_change_ci(
+                baseline_samples, candidate_samples, args.bootstrap_iterations, 1.0 - args.alpha, rng
+            )
+            significant = comparison.ci_low_percent > 0 or comparison.ci_high_percent < 0
+        else:
+            significant = p_value < args.alpha
+
+        if significant and change > args.threshold:
+            comparison.verdict = "REGRESSION"
+        elif significant and change < -args.threshold:
+            comparison.verdict = "improvement"
+        else:
+            comparison.verdict = "~"
+
+        ret.append(comparison)
+
+    return ret
+
+
+def format_ns(value: float) -> str:
+    if value >= 1000000.0:
+        return f"{value / 1000000.0:.3f} ms"
+    if value >= 1000.0:
+        return f"{value / 1000.0:.3f} us"
+    return f"{value:.0f} ns"
+
+
+def print_table(comparisons: list[Comparison], *, show_all: bool, bootstrap: bool):
+    rows = [comparison for comparison in comparisons if show_all or comparison.verdict != "~"]
+    if not rows:
+        print("  No significant changes")
+        return
+
+    name_width = max(len("Test"), *(len(row.name) for row in rows))
+    interval_header = f"  {'Change CI':>19}" if bootstrap else ""
+    print(
+        f"  {'Test':<{name_width}}  {'Baseline':>12}  {'Candidate':>12}  {'Change':>8}{interval_header}"
+        f"  {'Effect':>6}  {'p':>8}  Verdict"
+    )
+    for row in rows:
+        interval = ""
+        if bootstrap:
+            interval = f"  [{row.ci_low_percent:+7.2f}%,{row.ci_high_percent:+7.2f}%]"
+        print(
+            f"  {row.name:<{name_width}}  {format_ns(row.baseline_median_ns):>12}"
+            f"  {format_ns(row.candidate_median_ns):>12}  {row.change_percent:+7.2f}%{interval}"
+            f"  {row.effect_size:6.3f}  {row.p_value:8.2g}  {row.verdict}"
+        )
+
+
+def describe(results: RunResults) -> str:
+    ret = results.path
+    if results.git_revision:
+        ret += f" ({results.git_revision})"
+    if not results.complete:
+        ret += " [incomplete run]"
+    return ret
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare xemu-perf-tests results against a baseline.")
+    parser.add_argument("baseline", help="Results file used as the baseline.")
+    parser.add_argument("candidates", nargs="+", help="One or more results files to compare against the baseline.")
+    parser.add_argument(
+        "--method",
+        choices=["mann-whitney", "bootstrap"],
+        default="mann-whitney",
+        help="Statistical test used to decide whether a change is significant.",
+    )
+    parser.add_argument("--alpha", type=float, default=0.01, help="Significance level. Default: %(default)s")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=2.0,
+        help="Changes in median smaller than this percentage are treated as noise. Default: %(default)s",
+    )
+    parser.add_argument(
+        "--bootstrap-iterations", type=int, default=2000, help="Number of bootstrap resamples. Default: %(default)s"
+    )
+    parser.add_argument("--seed", type=int, default=0, help="Seed for bootstrap resampling. Default: %(default)s")
+    parser.add_argument("--all", action="store_true", help="Show every test, not just significant changes.")
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    failed = False
+
+    for candidate_path in args.candidates:
+        candidate = load_results(candidate_path)
+        print(f"Baseline:  {describe(baseline)}")
+        print(f"Candidate: {describe(candidate)}")
+
+        missing = sorted(set(baseline.tests) ^ set(candidate.tests))
+        if missing:
+            print(f"  {len(missing)} test(s) present in only one of the results were skipped")
+
+        comparisons = compare(baseline, candidate, args)
+        print_table(comparisons, show_all=args.all, bootstrap=args.method == "bootstrap")
+
+        regressions = sum(1 for comparison in comparisons if comparison.verdict == "REGRESSION")
+        improvements = sum(1 for comparison in comparisons if comparison.verdict == "improvement")
+        invalid = sum(1 for comparison in comparisons if comparison.verdict == "INVALID")
+        print(
+            f"  {len(comparisons)} compared, {regressions} regression(s), {improvements} improvement(s), "
+            f"{invalid} invalid"
+        )
+        print()
+
+        if not comparisons:
+            print(f"  No tests with at least {MIN_SAMPLES} samples in both results could be compared", file=sys.stderr)
+
+        failed = failed or regressions > 0 or invalid > 0 or not comparisons
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+# ruff: noqa: T201 `print` found
+
+"""Merges a binary raw samples sidecar back into its NDJSON results file.
+
+Each test_result record gains the `raw_ticks` and `raw_submit_ticks` arrays at the positions at which they appear when
+`binary_raw_samples` is disabled, so the records contain the same fields in the same order. The output is not
+byte-for-byte identical to such a run: whitespace and number formatting follow Python's `json` module, and the run
+header still describes the sidecar. See src/raw_sample_encoding.h for a description of the sidecar format.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+
+from results_loader import load_results
+
+
+def decode(results_path: str, samples_path: str | None, output) -> int:
+    try:
+        results = load_results(results_path, samples_path)
+    except ValueError as err:
+        print(err, file=sys.stderr)
+        return 1
+
+    for record in results.records:
+        output.write(json.dumps(record, separators=(",", ":")) + "\n")
+
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Merge a binary raw samples sidecar into its NDJSON results file.")
+    parser.add_argument("results", help="Path to the results.ndjson file.")
+    parser.add_argument(
+        "--samples",
+        help="Path to the raw samples sidecar. Defaults to the file referenced by the results run header.",
+    )
+    parser.add_argument("-o", "--output", help="Path at which the merged results should be written. Default: stdout.")
+    args = parser.parse_args()
+
+    if args.output:
+        with open(args.output, "w") as output:
+            sys.exit(decode(args.results, args.samples, output))
+    sys.exit(decode(args.results, args.samples, sys.stdout))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+
+# ruff: noqa: T201 `print` found
+
+"""Generates a self-contained HTML report from an xemu-perf-tests results file.
+
+The report contains a table per suite, a histogram of the per-iteration samples of every test and, if a baseline is
+given, the change relative to the baseline. If the tests_registry.json produced by
+.github/scripts/summarize_test_suites.py is provided, suite and test descriptions are included along with links to the
+Doxygen documentation. Tests annotated as invalid by compare_framebuffers.py are flagged. The report does not reference
+any external resources.
+"""
+
+from __future__ import annotations
+
+import argparse
+import datetime
+import json
+import os
+import statistics
+from collections import defaultdict
+from dataclasses import dataclass, field
+from typing import Any
+
+from compare_results import mann_whitney_u
+from jinja2 import Environment, FileSystemLoader
+from markupsafe import Markup
+from results_loader import RunResults, get_samples_ns, load_results
+
+DEFAULT_DOCS_URL = "https://abaire.github.io/xemu-perf-tests"
+
+HISTOGRAM_WIDTH = 360
+HISTOGRAM_HEIGHT = 90
+HISTOGRAM_BINS = 40
+CANDIDATE_COLOR = "#3572b0"
+BASELINE_COLOR = "#d9822b"
+
+
+@dataclass
+class TestReport:
+    name: str
+    description: str
+    iterations: int
+    median_ns: float | None
+    p90_ns: float | None
+    precision_percent: float | None
+    baseline_median_ns: float | None = None
+    change_percent: float | None = None
+    p_value: float | None = None
+    verdict: str = ""
+    histogram: Markup = Markup("")
+
+
+@dataclass
+class SuiteReport:
+    name: str
+    description: str = ""
+    docs_url: str = ""
+    tests: list[TestReport] = field(default_factory=list)
+
+
+def format_ns(value: float | None) -> str:
+    if value is None:
+        return "-"
+    if value >= 1000000.0:
+        return f"{value / 1000000.0:.3f} ms"
+    if value >= 1000.0:
+        return f"{value / 1000.0:.3f} us"
+    return f"{value:.0f} ns"
+
+
+def render_histogram(samples: list[float], baseline_samples: list[float]) -> Markup:
+    """Returns an inline SVG histogram of the given samples, with the baseline samples outlined if present."""
+    all_samples = samples + baseline_samples
+    if not all_samples:
+        return Markup("")
+
+    # Clip the range to the 1st..99th percentile so that a few extreme outliers do not flatten the distribution.
+    ordered = sorted(all_samples)
+    low = ordered[int(0.01 * (len(ordered) - 1))]
+    high = ordered[int(0.99 * (len(ordered) - 1))]
+    if high <= low:
+        high = low + 1.0
+    bin_width = (high - low) / HISTOGRAM_BINS
+
+    def bin_counts(values: list[float]) -> list[int]:
+        counts = [0] * HISTOGRAM_BINS
+        for value in values:
+            index = int((value - low) / bin_width)
+            counts[min(max(index, 0), HISTOGRAM_BINS - 1)] += 1
+        return counts
+
+    counts = bin_counts(samples)
+    baseline_counts = bin_counts(baseline_samples)
+
+    # Normalize each distribution independently so that sets with different iteration counts can be compared.
+    def normalize(values: list[int]) -> list[float]:
+        peak = max(values) if values else 0
+        return [value / peak if peak else 0.0 for value in values]
+
+    plot_height = HISTOGRAM_HEIGHT - 14
+    column_width = HISTOGRAM_WIDTH / HISTOGRAM_BINS
+    elements = []
+    for index, value in enumerate(normalize(counts)):
+        if not value:
+            continue
+        height = value * plot_height
+        elements.append(
+            f'<rect x="{index * column_width:.1f}" y="{plot_height - height:.1f}" width="{column_width:.1f}" '
+            f'height="{height:.1f}" fill="{CANDIDATE_COLOR}" fill-opacity="0.7"/>'
+        )
+
+    if baseline_samples:
+        points = []
+        for index, value in enumerate(normalize(baseline_counts)):
+            y = plot_height - value * plot_height
+            points.append(f"{index * column_width:.1f},{y:.1f}")
+            points.append(f"{(index + 1) * column_width:.1f},{y:.1f}")
+        elements.append(
+            f'<polyline points="{" ".join(points)}" fill="none" stroke="{BASELINE_COLOR}" stroke-width="1.5"/>'
+        )
+
+    def median_marker(values: list[float], color: str) -> str:
+        x = (statistics.median(values) - low) / (high - low) * HISTOGRAM_WIDTH
+        x = min(max(x, 0.0), HISTOGRAM_WIDTH)
+        return f'<line x1="{x:.1f}" y1="0" x2="{x:.1f}" y2="{plot_height}" stroke="{color}" stroke-dasharray="3,2"/>'
+
+    if samples:
+        elements.append(median_marker(samples, CANDIDATE_COLOR))
+    if baseline_samples:
+        elements.append(median_marker(baseline_samples, BASELINE_COLOR))
+
+    elements.append(
+        f'<text x="0" y="{HISTOGRAM_HEIGHT - 2}" font-size="10">{format_ns(low)}</text>'
+        f'<text x="{HISTOGRAM_WIDTH}" y="{HISTOGRAM_HEIGHT - 2}" font-size="10" text-anchor="end">'
+        f"{format_ns(high)}</text>"
+    )
+
+    return Markup(
+        f'<svg xmlns="http://www.w3.org/2000/svg" width="{HISTOGRAM_WIDTH}" height="{HISTOGRAM_HEIGHT}" '
+        f'viewBox="0 0 {HISTOGRAM_WIDTH} {HISTOGRAM_HEIGHT}">{"".join(elements)}</svg>'
+    )
+
+
+def load_registry(path: str | None) -> dict[str, dict[str, Any]]:
+    """Returns the tests_registry.json suite descriptors keyed by suite name."""
+    if not path:
+        return {}
+
+    with open(path) as infile:
+        registry = json.load(infile)
+    return {suite["suite"]: suite for suite in registry.get("test_suites", [])}
+
+
+def build_suites(
+    results: RunResults, baseline: RunResults | None, registry: dict[str, dict[str, Any]], docs_url: str, args
+) -> list[SuiteReport]:
+    suites: dict[str, SuiteReport] = {}
+    tests_by_suite: dict[str, list[str]] = defaultdict(list)
+    for name in results.tests:
+        suite_name, _, _test_name = name.partition("::")
+        tests_by_suite[suite_name].append(name)
+
+    for suite_name in sorted(tests_by_suite):
+        descriptor = registry.get(suite_name, {})
+        suite = SuiteReport(name=suite_name, description=" ".join(descriptor.get("description", [])))
+        if descriptor and docs_url:
+            # With case sensitive names (the default on Linux), Doxygen names class pages "class<ClassName>.html".
+            suite.docs_url = f"{docs_url}/class{descriptor['class']}.html"
+        suites[suite_name] = suite
+
+        for name in sorted(tests_by_suite[suite_name]):
+            record = results.tests[name]
+            samples = get_samples_ns(record)
+            test_name = name.partition("::")[2]
+            test = TestReport(
+                name=test_name,
+                description=descriptor.get("test_descriptions", {}).get(test_name, ""),
+                iterations=record.get("iterations", len(samples)),
+                median_ns=record.get("median_ns", statistics.median(samples) if samples else None),
+                p90_ns=record.get("p90_ns"),
+                precision_percent=record.get("precision_percent"),
+            )
+
+            baseline_samples: list[float] = []
+            if baseline and name in baseline.tests:
+                baseline_record = baseline.tests[name]
+                baseline_samples = get_samples_ns(baseline_record)
+                test.baseline_median_ns = baseline_record.get(
+                    "median_ns", statistics.median(baseline_samples) if baseline_samples else None
+                )
+                if test.baseline_median_ns and test.median_ns is not None:
+                    test.change_percent = (test.median_ns - test.baseline_median_ns) * 100.0 / test.baseline_median_ns
+                if baseline_samples and samples:
+                    _effect_size, test.p_value = mann_whitney_u(baseline_samples, samples)
+                    if test.p_value < args.alpha and test.change_percent is not None:
+                        if test.change_percent > args.threshold:
+                            test.verdict = "regression"
+                        elif test.change_percent < -args.threshold:
+                            test.verdict = "improvement"
+
+            # Results that rendered the wrong image are not meaningful, regardless of their timing.
+            if record.get("framebuffer_valid") is False:
+                test.verdict = "invalid"
+
+            test.histogram = render_histogram(samples, baseline_samples)
+            suite.tests.append(test)
+
+    return list(suites.values())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate an HTML report from xemu-perf-tests results.")
+    parser.add_argument("results", help="Results file to report on.")
+    parser.add_argument("--baseline", help="Results file to compare against.")
+    parser.add_argument("--registry", help="Path to the tests_registry.json generated from the Doxygen documentation.")
+    parser.add_argument(
+        "--docs-url",
+        default=DEFAULT_DOCS_URL,
+        help="Base URL of the Doxygen documentation, or an empty string to omit links. Default: %(default)s",
+    )
+    parser.add_argument("--alpha", type=float, default=0.01, help="Significance level. Default: %(default)s")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=2.0,
+        help="Changes in median smaller than this percentage are treated as noise. Default: %(default)s",
+    )
+    parser.add_argument("-o", "--output", default="report.html", help="Output path. Default: %(default)s")
+    args = parser.parse_args()
+
+    results = load_results(args.results)
+    baseline = load_results(args.baseline) if args.baseline else None
+    registry = load_registry(args.registry)
+
+    script_dir = os.path.dirname(os.path.realpath(__file__))
+    loader = FileSystemLoader(os.path.join(script_dir, "templates"))
+    env = Environment(loader=loader, autoescape=True)
+    env.filters["format_ns"] = format_ns
+
+    context = {
+        "results": results,
+        "baseline": baseline,
+        "header": results.header or {},
+        "suites": build_suites(results, baseline, registry, args.docs_url.rstrip("/"), args),
+        "generated_at": datetime.datetime.now(tz=datetime.timezone.utc).isoformat(timespec="seconds"),
+        "candidate_color": CANDIDATE_COLOR,
+        "baseline_color": BASELINE_COLOR,
+    }
+
+    template = env.get_template("report.html.j2")
+    with open(args.output, "w") as outfile:
+        outfile.write(template.render(context))
+    print(f"Wrote {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+
+# ruff: noqa: T201 `print` found
+
+"""Maintains a local SQLite history of xemu-perf-tests results and answers trend queries against it.
+
+Runs are keyed by the xemu build they were executed against (an arbitrary label such as a nightly version), the
+harness revision recorded in the results header, and the test name. Runs are ordered by their build date, which
+defaults to the time of ingestion.
+
+Examples:
+  results_history.py ingest results.ndjson --xemu-build v0.8.20 --build-date 2025-01-31
+  results_history.py trend "BusyPfifo::Busy" --window 5
+  results_history.py changepoints
+  results_history.py first-regressed "BusyPfifo::Busy" --threshold 5
+"""
+
+from __future__ import annotations
+
+import argparse
+import datetime
+import hashlib
+import json
+import os
+import sqlite3
+import statistics
+import sys
+
+from results_loader import get_samples_ns, load_results
+
+DEFAULT_DATABASE = os.path.join(os.path.expanduser("~"), ".xemu_perf_tests_history.sqlite")
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS runs (
+    id INTEGER PRIMARY KEY,
+    xemu_build TEXT NOT NULL,
+    harness_revision TEXT,
+    build_date TEXT NOT NULL,
+    ingested_at TEXT NOT NULL,
+    source_path TEXT NOT NULL,
+    source_sha256 TEXT NOT NULL UNIQUE,
+    complete INTEGER NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS results (
+    run_id INTEGER NOT NULL REFERENCES runs(id) ON DELETE CASCADE,
+    test TEXT NOT NULL,
+    iterations INTEGER,
+    median_ns REAL,
+    robust_average_ns REAL,
+    p90_ns REAL,
+    timer_frequency INTEGER,
+    raw_ticks TEXT,
+    PRIMARY KEY (run_id, test)
+);
+
+CREATE INDEX IF NOT EXISTS results_by_test ON results(test);
+"""
+
+
+def open_database(path: str) -> sqlite3.Connection:
+    connection = sqlite3.connect(path)
+    connection.execute("PRAGMA foreign_keys = ON")
+    connection.executescript(SCHEMA)
+    return connection
+
+
+def ingest(connection: sqlite3.Connection, args) -> int:
+    now = datetime.datetime.now(tz=datetime.timezone.utc).isoformat(timespec="seconds")
+    build_date = args.build_date or now
+
+    for path in args.results:
+        with open(path, "rb") as infile:
+            digest = hashlib.sha256(infile.read()).hexdigest()
+
+        if connection.execute("SELECT 1 FROM runs WHERE source_sha256 = ?", (digest,)).fetchone():
+            print(f"Skipping {path}: already ingested")
+            continue
+
+        results = load_results(path)
+        with connection:
+            cursor = connection.execute(
+                "INSERT INTO runs (xemu_build, harness_revision, build_date, ingested_at, source_path, source_sha256, "
+                "complete) VALUES (?, ?, ?, ?, ?, ?, ?)",
+                (args.xemu_build, results.git_revision, build_date, now, os.path.abspath(path), digest,
+                 int(results.complete)),
+            )
+            run_id = cursor.lastrowid
+
+            for name, record in results.tests.items():
+                samples = get_samples_ns(record)
+                median = record.get("median_ns")
+                if median is None and samples:
+                    median = statistics.median(samples)
+                connection.execute(
+                    "INSERT INTO results (run_id, test, iterations, median_ns, robust_average_ns, p90_ns, "
+                    "timer_frequency, raw_ticks) VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+                    (run_id, name, record.get("iterations"), median, record.get("robust_average_ns"),
+                     record.get("p90_ns"), record.get("timer_frequency"), json.dumps(record.get("raw_ticks", []))),
+                )
+
+        print(f"Ingested {len(results.tests)} test(s) from {path} as run {run_id} ({args.xemu_build})")
+
+    return 0
+
+
+def list_runs(connection: sqlite3.Connection, _args) -> int:
+    rows = connection.execute(
+        "SELECT runs.id, xemu_build, harness_revision, build_date, complete, COUNT(results.test) FROM runs "
+        "LEFT JOIN results ON results.run_id = runs.id GROUP BY runs.id ORDER BY build_date, runs.id"
+    ).fetchall()
+    print(f"{'Run':>5}  {'xemu build':<24}  {'Harness':<16}  {'Build date':<25}  Tests")
+    for run_id, build, revision, build_date, complete, num_tests in rows:
+        suffix = "" if complete else " (incomplete)"
+        print(f"{run_id:>5}  {build:<24}  {revision or '-':<16}  {build_date:<25}  {num_tests}{suffix}")
+    return 0
+
+
+def get_series(connection: sqlite3.Connection, test: str) -> list[tuple[str, str, str | None, float]]:
+    """Returns (build_date, xemu_build, harness_revision, median_ns) for every run of the given test, oldest first."""
+    return connection.execute(
+        "SELECT build_date, xemu_build, harness_revision, median_ns FROM results "
+        "JOIN runs ON runs.id = results.run_id WHERE test = ? AND median_ns IS NOT NULL "
+        "ORDER BY build_date, runs.id",
+        (test,),
+    ).fetchall()
+
+
+def get_test_names(connection: sqlite3.Connection) -> list[str]:
+    return [row[0] for row in connection.execute("SELECT DISTINCT test FROM results ORDER BY test")]
+
+
+def trend(connection: sqlite3.Connection, args) -> int:
+    series = get_series(connection, args.test)
+    if not series:
+        print(f"No results for {args.test}")
+        return 1
+
+    print(f"{'Build date':<25}  {'xemu build':<24}  {'Median':>12}  {'Rolling median':>14}")
+    medians = []
+    for build_date, build, _revision, median in series:
+        medians.append(median)
+        rolling = statistics.median(medians[-args.window :])
+        print(f"{build_date:<25}  {build:<24}  {median / 1000.0:>10.3f}us  {rolling / 1000.0:>12.3f}us")
+    return 0
+
+
+def find_change_points(values: list[float], min_segment: int, min_shift_percent: float) -> list[int]:
+    """Returns the indices at which the level of `values` shifts, using recursive binary segmentation.
+
+    Each segment is split where the split most reduces the sum of absolute deviations from the median of each side. The
+    split is accepted if the medians on either side differ by more than `min_shift_percent` and by more than three times
+    the median absolute difference between successive values of the whole segment, which keeps single noisy runs from
+    being reported.
+    """
+
+    def cost(segment: list[float]) -> float:
+        center = statistics.median(segment)
+        return sum(abs(value - center) for value in segment)
+
+    def segment(start: int, end: int) -> list[int]:
+        if end - start < 2 * min_segment:
+            return []
+
+        total_cost = cost(values[start:end])
+        best_index = None
+        best_reduction = 0.0
+        for split in range(start + min_segment, end - min_segment + 1):
+            reduction = total_cost - cost(values[start:split]) - cost(values[split:end])
+            if reduction > best_reduction:
+                best_reduction = reduction
+                best_index = split
+
+        if best_index is None:
+            return []
+
+        before = values[start:best_index]
+        after = values[best_index:end]
+        before_median = statistics.median(before)
+        after_median = statistics.median(after)
+        shift = abs(after_median - before_median)
+        if before_median <= 0 or shift * 100.0 / before_median < min_shift_percent:
+            return []
+
+        # Differences between successive runs measure the noise of the whole segment without being inflated by any
+        # other level shifts within it.
+        noise = statistics.median(abs(values[index + 1] - values[index]) for index in range(start, end - 1))
+        if shift <= 3.0 * noise:
+            return []
+
+        return [*segment(start, best_index), best_index, *segment(best_index, end)]
+
+    return segment(0, len(values))
+
+
+def changepoints(connection: sqlite3.Connection, args) -> int:
+    tests = [args.test] if args.test else get_test_names(connection)
+    found = False
+    for test in tests:
+        series = get_series(connection, test)
+        medians = [row[3] for row in series]
+        for index in find_change_points(medians, args.min_segment, args.threshold):
+            before = statistics.median(medians[max(0, index - args.min_segment) : index])
+            after = statistics.median(medians[index : index + args.min_segment])
+            change = (after - before) * 100.0 / before
+            build_date, build, revision, _median = series[index]
+            direction = "slower" if change > 0 else "faster"
+            print(
+                f"{test}: {change:+.2f}% ({direction}) starting with {build} ({build_date}, harness {revision or '-'})"
+            )
+            found = True
+
+    if not found:
+        print("No change points found")
+    return 0
+
+
+def first_regressed(connection: sqlite3.Connection, args) -> int:
+    series = get_series(connection, args.test)
+    if not series:
+        print(f"No results for {args.test}")
+        return 1
+
+    start = 0
+    if args.good:
+        matches = [index for index, row in enumerate(series) if row[1] == args.good]
+        if not matches:
+            print(f"No results for {args.test} with xemu build {args.good}")
+            return 1
+        start = matches[-1]
+
+    baseline = series[start][3]
+    limit = baseline * (1.0 + args.threshold / 100.0)
+
+    # Require several consecutive regressed runs so that a single noisy run is not blamed.
+    for index in range(start + 1, len(series)):
+        following = series[index : index + args.confirm]
+        if not all(row[3] > limit for row in following):
+            continue
+
+        build_date, build, revision, median = series[index]
+        previous_build = series[index - 1][1]
+        change = (median - baseline) * 100.0 / baseline
+        if len(following) < args.confirm:
+            print(
+                f"{args.test} may have regressed in {build} ({build_date}, harness {revision or '-'}): "
+                f"{change:+.2f}% relative to {series[start][1]}, but this is unconfirmed as only {len(following)} of "
+                f"the {args.confirm} required run(s) have been ingested. Last good build: {previous_build}"
+            )
+            return 0
+
+        print(
+            f"{args.test} first regressed in {build} ({build_date}, harness {revision or '-'}): {change:+.2f}% "
+            f"relative to {series[start][1]}. Last good build: {previous_build}"
+        )
+        return 0
+
+    print(f"{args.test} has not regressed by more than {args.threshold}% relative to {series[start][1]}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Track xemu-perf-tests results over time.")
+    parser.add_argument(
+        "--database", default=DEFAULT_DATABASE, help="Path to the history database. Default: %(default)s"
+    )
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    ingest_parser = subparsers.add_parser("ingest", help="Add result files to the history.")
+    ingest_parser.add_argument("results", nargs="+", help="Results files to ingest.")
+    ingest_parser.add_argument("--xemu-build", required=True, help="Label identifying the xemu build that was tested.")
+    ingest_parser.add_argument(
+        "--build-date", help="ISO 8601 date of the xemu build, used to order runs. Default: the current time."
+    )
+    ingest_parser.set_defaults(handler=ingest)
+
+    list_parser = subparsers.add_parser("list", help="List ingested runs.")
+    list_parser.set_defaults(handler=list_runs)
+
+    trend_parser = subparsers.add_parser("trend", help="Show the median time of a test across runs.")
+    trend_parser.add_argument("test", help="Name of the test in 'Suite::Test' form.")
+    trend_parser.add_argument("--window", type=int, default=5, help="Rolling median window. Default: %(default)s")
+    trend_parser.set_defaults(handler=trend)
+
+    changepoint_parser = subparsers.add_parser("changepoints", help="Find runs where the level of a test shifted.")
+    changepoint_parser.add_argument("test", nargs="?", help="Name of the test. Default: all tests.")
+    changepoint_parser.add_argument(
+        "--threshold", type=float, default=5.0, help="Minimum shift in percent. Default: %(default)s"
+    )
+    changepoint_parser.add_argument(
+        "--min-segment", type=int, default=3, help="Minimum number of runs on each side. Default: %(default)s"
+    )
+    changepoint_parser.set_defaults(handler=changepoints)
+
+    regressed_parser = subparsers.add_parser("first-regressed", help="Find the first build in which a test regressed.")
+    regressed_parser.add_argument("test", help="Name of the test in 'Suite::Test' form.")
+    regressed_parser.add_argument("--good", help="xemu build known to be good. Default: the oldest run.")
+    regressed_parser.add_argument(
+        "--threshold", type=float, default=5.0, help="Regression threshold in percent. Default: %(default)s"
+    )
+    regressed_parser.add_argument(
+        "--confirm", type=int, default=2, help="Number of consecutive regressed runs required. Default: %(default)s"
+    )
+    regressed_parser.set_defaults(handler=first_regressed)
+
+    args = parser.parse_args()
+
+    connection = open_database(args.database)
+    try:
+        sys.exit(args.handler(connection, args))
+    finally:
+        connection.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,207 @@
+"""Loads results files produced by xemu-perf-tests for use by the host side tools in this directory.
+
+Both the NDJSON format (with or without a binary raw samples sidecar) and the legacy `results.txt` format (a JSON array
+whose entries each end with a trailing comma) are supported.
+"""
+
+from __future__ import annotations
+
+import json
+import os
+import re
+import struct
+import sys
+from dataclasses import dataclass, field
+from typing import Any, BinaryIO
+
+RAW_SAMPLE_MAGIC = b"XPRS"
+RAW_SAMPLE_FORMAT_VERSION = 1
+FLAG_HAS_SUBMIT_SAMPLES = 0x01
+
+NANOSECONDS_PER_SECOND = 1000000000.0
+
+# Legacy results record raw_results in microseconds.
+LEGACY_TIMER_FREQUENCY = 1000000
+
+
+class RawSampleReader:
+    """Reads records from a raw samples sidecar file (see src/raw_sample_encoding.h)."""
+
+    def __init__(self, stream: BinaryIO):
+        self._stream = stream
+
+        header = stream.read(16)
+        if len(header) != 16:
+            msg = "Truncated raw samples header"
+            raise ValueError(msg)
+        magic, version, self.timer_frequency = struct.unpack("<4sIQ", header)
+        if magic != RAW_SAMPLE_MAGIC:
+            msg = f"Invalid raw samples magic {magic!r}"
+            raise ValueError(msg)
+        if version != RAW_SAMPLE_FORMAT_VERSION:
+            msg = f"Unsupported raw samples version {version}"
+            raise ValueError(msg)
+
+    def _read_byte(self) -> int:
+        value = self._stream.read(1)
+        if not value:
+            raise EOFError
+        return value[0]
+
+    def _read_varint(self) -> int:
+        ret = 0
+        shift = 0
+        while True:
+            value = self._read_byte()
+            ret |= (value & 0x7F) << shift
+            if not value & 0x80:
+                return ret
+            shift += 7
+
+    def _read_samples(self) -> list[int]:
+        count = self._read_varint()
+        ret = []
+        previous = 0
+        for _ in range(count):
+            zigzag = self._read_varint()
+            delta = (zigzag >> 1) ^ -(zigzag & 1)
+            previous = (previous + delta) & 0xFFFFFFFFFFFFFFFF
+            ret.append(previous)
+        return ret
+
+    def read_record(self) -> tuple[str, list[int], list[int] | None] | None:
+        """Returns (name, raw_ticks, raw_submit_ticks) or None at the end of the file."""
+        try:
+            name_length = self._read_varint()
+        except EOFError:
+            return None
+
+        name = self._stream.read(name_length).decode("utf-8")
+        flags = self._read_byte()
+        raw_ticks = self._read_samples()
+        raw_submit_ticks = self._read_samples() if flags & FLAG_HAS_SUBMIT_SAMPLES else None
+        return name, raw_ticks, raw_submit_ticks
+
+
+@dataclass
+class RunResults:
+    """The contents of a single results file."""
+
+    path: str
+    #: The run_header record, or None for legacy results.
+    header: dict[str, Any] | None = None
+    #: Records of every type, in file order.
+    records: list[dict[str, Any]] = field(default_factory=list)
+    #: test_result records keyed by "suite::test" name.
+    tests: dict[str, dict[str, Any]] = field(default_factory=dict)
+    #: Whether the run wrote a footer. Always True for legacy results, which have no footer.
+    complete: bool = False
+
+    @property
+    def git_revision(self) -> str | None:
+        return self.header.get("git_revision") if self.header else None
+
+
+def get_samples_ns(record: dict[str, Any]) -> list[float]:
+    """Returns the per-iteration times of the given test_result in nanoseconds."""
+    frequency = record.get("timer_frequency")
+    if not frequency:
+        return []
+    scale = NANOSECONDS_PER_SECOND / frequency
+    return [ticks * scale for ticks in record.get("raw_ticks", [])]
+
+
+def merge_raw_samples(records: list[dict[str, Any]], samples_path: str):
+    """Replaces `raw_ticks_in_sidecar` markers with the arrays read from the given sidecar file."""
+    with open(samples_path, "rb") as samples_file:
+        reader = RawSampleReader(samples_file)
+
+        for record in records:
+            if record.get("type") != "test_result" or not record.pop("raw_ticks_in_sidecar", False):
+                continue
+
+            sample_record = reader.read_record()
+            if not sample_record:
+                msg = f"{samples_path} ended before the samples for {record['name']}"
+                raise ValueError(msg)
+
+            name, raw_ticks, raw_submit_ticks = sample_record
+            if name != record["name"]:
+                msg = f"Sample record {name} does not match result {record['name']}"
+                raise ValueError(msg)
+
+            # Insert the arrays where the harness writes them when binary_raw_samples is disabled, preserving key order.
+            merged = {}
+            for key, value in record.items():
+                merged[key] = value
+                if key == "submit_average_ns" and raw_submit_ticks is not None:
+                    merged["raw_submit_ticks"] = raw_submit_ticks
+            if raw_submit_ticks is not None and "raw_submit_ticks" not in merged:
+                merged["raw_submit_ticks"] = raw_submit_ticks
+            merged["raw_ticks"] = raw_ticks
+            record.clear()
+            record.update(merged)
+
+
+def _load_legacy_records(content: str) -> list[dict[str, Any]]:
+    # Legacy results terminate every entry (including the last) with a comma.
+    repaired = re.sub(r",(\s*[\]}])", r"\1", content)
+    ret = []
+    for entry in json.loads(repaired):
+        if "run_plan" in entry:
+            ret.append({"type": "run_plan", **entry["run_plan"]})
+        elif "calibrated_workload" in entry:
+            ret.append({"type": "workload_calibration", **entry})
+        else:
+            record = {"type": "test_result", **entry}
+            if "raw_ticks" not in record and "raw_results" in record:
+                record["timer_frequency"] = LEGACY_TIMER_FREQUENCY
+                record["raw_ticks"] = record["raw_results"]
+            ret.append(record)
+    return ret
+
+
+def load_results(path: str, samples_path: str | None = None, *, merge_samples: bool = True) -> RunResults:
+    """Loads the given results file.
+
+    If the run wrote raw samples to a binary sidecar, it is merged into the test_result records unless `merge_samples`
+    is False. `samples_path` defaults to the sidecar referenced by the run header.
+    """
+    with open(path) as infile:
+        content = infile.read()
+
+    ret = RunResults(path=path)
+
+    if content.lstrip().startswith("["):
+        ret.records = _load_legacy_records(content)
+        ret.complete = True
+    else:
+        for line_number, line in enumerate(content.splitlines(), start=1):
+            if not line.strip():
+                continue
+            try:
+                ret.records.append(json.loads(line))
+            except json.JSONDecodeError:
+                # The final line of a crashed run may be truncated.
+                print(f"Ignoring malformed line {line_number} in {path}", file=sys.stderr)
+
+    for record in ret.records:
+        record_type = record.get("type")
+        if record_type == "run_header":
+            ret.header = record
+        elif record_type == "run_footer":
+            ret.complete = True
+
+    if merge_samples and any(record.get("raw_ticks_in_sidecar") for record in ret.records):
+        if not samples_path:
+            if not ret.header or "raw_samples_file" not in ret.header:
+                msg = f"{path} does not reference a raw samples file"
+                raise ValueError(msg)
+            samples_path = os.path.join(os.path.dirname(path), ret.header["raw_samples_file"])
+        merge_raw_samples(ret.records, samples_path)
+
+    for record in ret.records:
+        if record.get("type") == "test_result":
+            ret.tests[record["name"]] = record
+
+    return ret
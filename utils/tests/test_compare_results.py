@@ -0,0 +1,61 @@
+"""Tests for compare_results.py and the legacy results support in results_loader.py.
+
+Run from the repository root with `python3 -m unittest discover -s utils/tests`.
+"""
+
+from __future__ import annotations
+
+import os
+import subprocess
+import sys
+import unittest
+
+UTILS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "data")
+sys.path.insert(0, UTILS_DIR)
+
+from results_loader import get_samples_ns, load_results  # noqa: E402
+
+
+def _run_compare(*paths: str) -> subprocess.CompletedProcess:
+    return subprocess.run(
+        [sys.executable, os.path.join(UTILS_DIR, "compare_results.py"), *paths],
+        capture_output=True,
+        text=True,
+        check=False,
+    )
+
+
+class LegacyResultsTest(unittest.TestCase):
+    def test_legacy_raw_results_are_loaded_as_microsecond_samples(self):
+        results = load_results(os.path.join(DATA_DIR, "legacy_baseline.txt"))
+
+        record = results.tests["TinyDraw::Arrays"]
+        samples = get_samples_ns(record)
+        self.assertEqual(len(samples), 20)
+        self.assertEqual(samples[0], record["raw_results"][0] * 1000.0)
+
+    def test_legacy_regression_is_reported(self):
+        result = _run_compare(
+            os.path.join(DATA_DIR, "legacy_baseline.txt"), os.path.join(DATA_DIR, "legacy_regressed.txt")
+        )
+
+        self.assertEqual(result.returncode, 1, result.stdout)
+        self.assertIn("2 compared, 2 regression(s)", result.stdout)
+
+    def test_legacy_identical_results_pass(self):
+        baseline = os.path.join(DATA_DIR, "legacy_baseline.txt")
+        result = _run_compare(baseline, baseline)
+
+        self.assertEqual(result.returncode, 0, result.stdout)
+        self.assertIn("2 compared, 0 regression(s)", result.stdout)
+
+    def test_nothing_compared_fails(self):
+        result = _run_compare(os.path.join(DATA_DIR, "legacy_baseline.txt"), os.path.join(DATA_DIR, "empty.txt"))
+
+        self.assertEqual(result.returncode, 1, result.stdout)
+        self.assertIn("0 compared", result.stdout)
+
+
+if __name__ == "__main__":
+    unittest.main()
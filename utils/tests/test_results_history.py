@@ -0,0 +1,102 @@
+"""Tests for results_history.py.
+
+Run from the repository root with `python3 -m unittest discover -s utils/tests`.
+"""
+
+from __future__ import annotations
+
+import argparse
+import contextlib
+import io
+import os
+import random
+import sys
+import unittest
+
+UTILS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "data")
+sys.path.insert(0, UTILS_DIR)
+
+from results_history import find_change_points, first_regressed, get_series, ingest, open_database  # noqa: E402
+
+
+class FindChangePointsTest(unittest.TestCase):
+    def test_single_step(self):
+        self.assertEqual(find_change_points([100.0] * 6 + [120.0] * 4, 3, 5.0), [6])
+
+    def test_single_step_in_long_flat_segments(self):
+        self.assertEqual(find_change_points([100.0] * 8 + [120.0] * 8, 3, 5.0), [8])
+
+    def test_two_steps(self):
+        self.assertEqual(find_change_points([100.0] * 5 + [120.0] * 5 + [90.0] * 5, 3, 5.0), [5, 10])
+
+    def test_flat(self):
+        self.assertEqual(find_change_points([100.0] * 10, 3, 5.0), [])
+
+    def test_single_outlier_is_ignored(self):
+        self.assertEqual(find_change_points([100.0] * 5 + [150.0] + [100.0] * 5, 3, 5.0), [])
+
+    def test_noisy_step(self):
+        rng = random.Random(0)
+        values = [100.0 + rng.gauss(0, 2) for _ in range(10)] + [120.0 + rng.gauss(0, 2) for _ in range(10)]
+        self.assertEqual(find_change_points(values, 3, 5.0), [10])
+
+
+class HistoryDatabaseTest(unittest.TestCase):
+    def setUp(self):
+        self.connection = open_database(":memory:")
+
+    def tearDown(self):
+        self.connection.close()
+
+    def _insert(self, build: str, median_ns: float):
+        cursor = self.connection.execute(
+            "INSERT INTO runs (xemu_build, build_date, ingested_at, source_path, source_sha256, complete) "
+            "VALUES (?, ?, '', '', ?, 1)",
+            (build, build, build),
+        )
+        self.connection.execute(
+            "INSERT INTO results (run_id, test, median_ns) VALUES (?, 'Suite::Test', ?)", (cursor.lastrowid, median_ns)
+        )
+
+    def _first_regressed(self, confirm: int) -> str:
+        args = argparse.Namespace(test="Suite::Test", good=None, threshold=5.0, confirm=confirm)
+        output = io.StringIO()
+        with contextlib.redirect_stdout(output):
+            first_regressed(self.connection, args)
+        return output.getvalue()
+
+    def test_legacy_results_are_ingested_with_a_median(self):
+        args = argparse.Namespace(results=[os.path.join(DATA_DIR, "legacy_baseline.txt")], xemu_build="v1", build_date=None)
+        with contextlib.redirect_stdout(io.StringIO()):
+            ingest(self.connection, args)
+
+        series = get_series(self.connection, "TinyDraw::Arrays")
+        self.assertEqual(len(series), 1)
+        self.assertAlmostEqual(series[0][3], 1000000.0, delta=20000.0)
+
+    def test_first_regressed_confirmed(self):
+        for index, median in enumerate([100.0, 100.0, 120.0, 120.0]):
+            self._insert(f"b{index}", median)
+
+        output = self._first_regressed(confirm=2)
+        self.assertIn("first regressed in b2", output)
+
+    def test_first_regressed_unconfirmed(self):
+        for index, median in enumerate([100.0, 100.0, 100.0, 120.0]):
+            self._insert(f"b{index}", median)
+
+        output = self._first_regressed(confirm=2)
+        self.assertIn("unconfirmed", output)
+        self.assertIn("b3", output)
+
+    def test_not_regressed(self):
+        for index, median in enumerate([100.0, 120.0, 100.0, 100.0]):
+            self._insert(f"b{index}", median)
+
+        output = self._first_regressed(confirm=2)
+        self.assertIn("has not regressed", output)
+
+
+if __name__ == "__main__":
+    unittest.main()